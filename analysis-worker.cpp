@@ -0,0 +1,46 @@
+#include "analysis-worker.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "util/platform.h"
+
+std::mutex AnalysisWorker::mutex;
+std::condition_variable AnalysisWorker::condition;
+std::vector<AnalysisTask *> AnalysisWorker::tasks;
+std::thread AnalysisWorker::thread;
+bool AnalysisWorker::stopping = false;
+
+void AnalysisWorker::Run()
+{
+	os_set_thread_name("source-dock: audio analysis");
+	std::unique_lock<std::mutex> lock(mutex);
+	while (!stopping) {
+		const uint64_t ts = os_gettime_ns();
+		for (auto task : tasks)
+			task->Process(ts);
+		condition.wait_for(lock, std::chrono::milliseconds(ANALYSIS_INTERVAL_MS));
+	}
+}
+
+void AnalysisWorker::AddTask(AnalysisTask *task)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	tasks.push_back(task);
+	if (thread.joinable())
+		return;
+	stopping = false;
+	thread = std::thread(Run);
+}
+
+void AnalysisWorker::RemoveTask(AnalysisTask *task)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	tasks.erase(std::remove(tasks.begin(), tasks.end(), task), tasks.end());
+	if (!tasks.empty() || !thread.joinable())
+		return;
+	stopping = true;
+	lock.unlock();
+	condition.notify_all();
+	thread.join();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define ANALYSIS_INTERVAL_MS 20
+
+class AnalysisTask {
+public:
+	virtual ~AnalysisTask() = default;
+	// Called on the shared analysis thread, never concurrently with itself.
+	virtual void Process(uint64_t ts) = 0;
+};
+
+// One thread that runs all audio analysis tasks, instead of a thread per dock.
+// The thread is started with the first task and stopped with the last.
+class AnalysisWorker {
+	static std::mutex mutex;
+	static std::condition_variable condition;
+	static std::vector<AnalysisTask *> tasks;
+	static std::thread thread;
+	static bool stopping;
+
+	static void Run();
+
+public:
+	static void AddTask(AnalysisTask *task);
+	// Blocks until the task is not being processed anymore.
+	static void RemoveTask(AnalysisTask *task);
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Lock-free single producer, single consumer ring of mono samples.
+// The producer is an audio capture callback, the consumer copies the
+// latest samples out. The ring must be big enough that the consumer is
+// done copying before the producer laps it.
+class AudioRing {
+	std::vector<float> buffer;
+	size_t mask;
+	std::atomic<uint32_t> sequence{0};
+	std::atomic<uint64_t> writePos{0};
+	std::atomic<uint64_t> endTimestamp{0};
+
+public:
+	explicit AudioRing(size_t minimumSize)
+	{
+		size_t size = 1;
+		while (size < minimumSize)
+			size <<= 1;
+		buffer.resize(size);
+		mask = size - 1;
+	}
+
+	size_t Size() const { return buffer.size(); }
+
+	void Reset()
+	{
+		sequence.fetch_add(1, std::memory_order_acq_rel);
+		writePos.store(0, std::memory_order_relaxed);
+		endTimestamp.store(0, std::memory_order_relaxed);
+		sequence.fetch_add(1, std::memory_order_acq_rel);
+	}
+
+	// timestamp is the time in ns just after the last written sample.
+	void Write(const float *data, size_t count, uint64_t timestamp)
+	{
+		uint64_t pos = writePos.load(std::memory_order_relaxed);
+		size_t offset = pos & mask;
+		size_t first = count < buffer.size() - offset ? count : buffer.size() - offset;
+		memcpy(buffer.data() + offset, data, first * sizeof(float));
+		if (count > first)
+			memcpy(buffer.data(), data + first, (count - first) * sizeof(float));
+
+		sequence.fetch_add(1, std::memory_order_acq_rel);
+		writePos.store(pos + count, std::memory_order_relaxed);
+		endTimestamp.store(timestamp, std::memory_order_relaxed);
+		sequence.fetch_add(1, std::memory_order_release);
+	}
+
+	uint64_t Written() const { return writePos.load(std::memory_order_acquire); }
+
+	// Copies the latest count samples, returns false when not enough samples
+	// were written yet.
+	bool ReadLatest(float *data, size_t count, uint64_t *timestamp = nullptr) const
+	{
+		if (count > buffer.size())
+			return false;
+		uint64_t pos;
+		uint64_t ts;
+		uint32_t seq;
+		do {
+			seq = sequence.load(std::memory_order_acquire);
+			pos = writePos.load(std::memory_order_relaxed);
+			ts = endTimestamp.load(std::memory_order_relaxed);
+		} while ((seq & 1) || seq != sequence.load(std::memory_order_acquire));
+
+		if (pos < count)
+			return false;
+		size_t offset = (pos - count) & mask;
+		size_t first = count < buffer.size() - offset ? count : buffer.size() - offset;
+		memcpy(data, buffer.data() + offset, first * sizeof(float));
+		if (count > first)
+			memcpy(data + first, buffer.data(), (count - first) * sizeof(float));
+		if (timestamp)
+			*timestamp = ts;
+		return true;
+	}
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Collapses a burst of signals into a single refresh. Signal can be called
+// from any thread and only returns true for the first signal since the last
+// Begin, that caller queues the refresh. Begin is called by the refresh
+// itself before it reads the state, so a signal arriving during the refresh
+// queues the next one and is never lost.
+class CoalescedRefresh {
+	std::atomic<bool> pending{false};
+	std::atomic<uint64_t> signals{0};
+	uint64_t refreshes = 0;
+
+public:
+	bool Signal()
+	{
+		signals++;
+		return !pending.exchange(true);
+	}
+
+	void Begin()
+	{
+		pending = false;
+		refreshes++;
+	}
+
+	// Returns the counts since the last call and resets them, only call it
+	// from the thread that calls Begin.
+	void TakeCounts(uint64_t &signalCount, uint64_t &refreshCount)
+	{
+		signalCount = signals.exchange(0);
+		refreshCount = refreshes;
+		refreshes = 0;
+	}
+};
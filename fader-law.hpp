@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cmath>
+
+// Maps a fader position (0.0 - 1.0, "def") to a level in dB and back.
+// The log law is the one OBS uses for its faders, it is evaluated from a
+// table that is generated at compile time. The other laws are piecewise
+// linear in dB.
+enum fader_law {
+	FADER_LAW_LOG = 0,
+	FADER_LAW_LINEAR_DB = 1,
+	FADER_LAW_IEC = 2,
+};
+
+#define FADER_LAW_COUNT 3
+#define FADER_LAW_TABLE_SIZE 1025
+#define FADER_LAW_MINIMUM_DB -96.0f
+
+namespace fader_law_detail {
+
+constexpr double log_offset_db = 6.0;
+constexpr double log_range_db = 96.0;
+/* equals log((log_range_db + log_offset_db) / log_offset_db) */
+constexpr double log_curve = 2.83321334405621608;
+
+constexpr double const_exp(double x)
+{
+	// Halve until the series converges quickly, then square back up.
+	int halvings = 0;
+	while (x > 0.5 || x < -0.5) {
+		x /= 2.0;
+		halvings++;
+	}
+	double sum = 1.0;
+	double term = 1.0;
+	for (int i = 1; i < 20; i++) {
+		term *= x / i;
+		sum += term;
+	}
+	while (halvings-- > 0)
+		sum *= sum;
+	return sum;
+}
+
+struct LogTable {
+	float db[FADER_LAW_TABLE_SIZE];
+};
+
+constexpr LogTable make_log_table()
+{
+	LogTable table{};
+	for (int i = 0; i < FADER_LAW_TABLE_SIZE; i++) {
+		const double def = double(i) / double(FADER_LAW_TABLE_SIZE - 1);
+		table.db[i] = (float)(-(log_range_db + log_offset_db) * const_exp(-def * log_curve) + log_offset_db);
+	}
+	return table;
+}
+
+constexpr LogTable log_table = make_log_table();
+
+struct Point {
+	float def;
+	float db;
+};
+
+// IEC 60268-18 style scale, same break points as the OBS IEC fader.
+constexpr Point iec_points[] = {
+	{0.0f, -150.0f}, {0.025f, -60.0f}, {0.075f, -50.0f}, {0.15f, -40.0f},
+	{0.3f, -30.0f},  {0.5f, -20.0f},   {0.75f, -9.0f},   {1.0f, 0.0f},
+};
+constexpr int iec_point_count = sizeof(iec_points) / sizeof(iec_points[0]);
+
+inline float log_def_to_db(float def)
+{
+	const float position = def * float(FADER_LAW_TABLE_SIZE - 1);
+	const int index = (int)position;
+	if (index >= FADER_LAW_TABLE_SIZE - 1)
+		return log_table.db[FADER_LAW_TABLE_SIZE - 1];
+	const float fraction = position - float(index);
+	return log_table.db[index] + (log_table.db[index + 1] - log_table.db[index]) * fraction;
+}
+
+inline float log_db_to_def(float db)
+{
+	// The table is increasing, find the segment that holds db.
+	int low = 0;
+	int high = FADER_LAW_TABLE_SIZE - 1;
+	while (high - low > 1) {
+		const int mid = (low + high) / 2;
+		if (log_table.db[mid] <= db)
+			low = mid;
+		else
+			high = mid;
+	}
+	const float range = log_table.db[high] - log_table.db[low];
+	const float fraction = range > 0.0f ? (db - log_table.db[low]) / range : 0.0f;
+	return (float(low) + fraction) / float(FADER_LAW_TABLE_SIZE - 1);
+}
+
+inline float iec_def_to_db(float def)
+{
+	if (def < 0.001f)
+		return -INFINITY;
+	for (int i = 1; i < iec_point_count; i++) {
+		if (def <= iec_points[i].def) {
+			const Point &a = iec_points[i - 1];
+			const Point &b = iec_points[i];
+			return a.db + (def - a.def) / (b.def - a.def) * (b.db - a.db);
+		}
+	}
+	return 0.0f;
+}
+
+inline float iec_db_to_def(float db)
+{
+	if (db <= iec_points[0].db)
+		return 0.0f;
+	for (int i = 1; i < iec_point_count; i++) {
+		if (db <= iec_points[i].db) {
+			const Point &a = iec_points[i - 1];
+			const Point &b = iec_points[i];
+			return a.def + (db - a.db) / (b.db - a.db) * (b.def - a.def);
+		}
+	}
+	return 1.0f;
+}
+
+} // namespace fader_law_detail
+
+inline float fader_def_to_db(int law, float def)
+{
+	if (def >= 1.0f)
+		return 0.0f;
+	if (def <= 0.0f)
+		return -INFINITY;
+	switch (law) {
+	case FADER_LAW_LINEAR_DB:
+		return FADER_LAW_MINIMUM_DB * (1.0f - def);
+	case FADER_LAW_IEC:
+		return fader_law_detail::iec_def_to_db(def);
+	default:
+		return fader_law_detail::log_def_to_db(def);
+	}
+}
+
+inline float fader_db_to_def(int law, float db)
+{
+	if (db >= 0.0f)
+		return 1.0f;
+	switch (law) {
+	case FADER_LAW_LINEAR_DB:
+		return db <= FADER_LAW_MINIMUM_DB ? 0.0f : 1.0f - db / FADER_LAW_MINIMUM_DB;
+	case FADER_LAW_IEC:
+		return fader_law_detail::iec_db_to_def(db);
+	default:
+		return db <= FADER_LAW_MINIMUM_DB ? 0.0f : fader_law_detail::log_db_to_def(db);
+	}
+}
+
+inline const char *fader_law_name(int law)
+{
+	switch (law) {
+	case FADER_LAW_LINEAR_DB:
+		return "FaderLawLinearDb";
+	case FADER_LAW_IEC:
+		return "FaderLawIEC";
+	default:
+		return "FaderLawLog";
+	}
+}
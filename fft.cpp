@@ -0,0 +1,61 @@
+#include "fft.hpp"
+
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+size_t FFT::NextPowerOfTwo(size_t n)
+{
+	size_t size = 1;
+	while (size < n)
+		size <<= 1;
+	return size;
+}
+
+FFT::FFT(size_t size_) : size(NextPowerOfTwo(size_))
+{
+	size_t bits = 0;
+	while (((size_t)1 << bits) < size)
+		bits++;
+
+	bitReverse.resize(size);
+	for (size_t i = 0; i < size; i++) {
+		size_t r = 0;
+		for (size_t b = 0; b < bits; b++) {
+			if (i & ((size_t)1 << b))
+				r |= (size_t)1 << (bits - 1 - b);
+		}
+		bitReverse[i] = r;
+	}
+
+	twiddles.resize(size / 2);
+	for (size_t i = 0; i < size / 2; i++) {
+		const double angle = -2.0 * M_PI * double(i) / double(size);
+		twiddles[i] = std::complex<float>((float)cos(angle), (float)sin(angle));
+	}
+}
+
+void FFT::Transform(std::complex<float> *data, bool inverse) const
+{
+	for (size_t i = 0; i < size; i++) {
+		const size_t r = bitReverse[i];
+		if (r > i)
+			std::swap(data[i], data[r]);
+	}
+
+	for (size_t half = 1; half < size; half <<= 1) {
+		const size_t step = size / (half * 2);
+		for (size_t start = 0; start < size; start += half * 2) {
+			for (size_t k = 0; k < half; k++) {
+				std::complex<float> w = twiddles[k * step];
+				if (inverse)
+					w = std::conj(w);
+				const std::complex<float> t = w * data[start + k + half];
+				data[start + k + half] = data[start + k] - t;
+				data[start + k] += t;
+			}
+		}
+	}
+}
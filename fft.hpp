@@ -0,0 +1,25 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+// Iterative radix-2 FFT with the twiddle factors and bit reversal
+// precomputed for one size, so repeated transforms only do the butterflies.
+class FFT {
+	size_t size;
+	std::vector<size_t> bitReverse;
+	std::vector<std::complex<float>> twiddles;
+
+	void Transform(std::complex<float> *data, bool inverse) const;
+
+public:
+	explicit FFT(size_t size);
+
+	size_t Size() const { return size; }
+
+	void Forward(std::complex<float> *data) const { Transform(data, false); }
+	// Not normalized, divide by Size() when needed.
+	void Inverse(std::complex<float> *data) const { Transform(data, true); }
+
+	static size_t NextPowerOfTwo(size_t n);
+};
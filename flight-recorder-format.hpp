@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// The file layout of the flight recorder ring, shared by the plugin and the
+// flight-recorder-dump tool. It depends on neither Qt nor libobs.
+
+#define FLIGHT_RECORD_TALLY 1
+#define FLIGHT_RECORD_LEVEL 2
+#define FLIGHT_RECORD_VOLUME 3
+#define FLIGHT_RECORD_MUTE 4
+#define FLIGHT_RECORD_MEDIA_PLAY 5
+#define FLIGHT_RECORD_MEDIA_PAUSE 6
+#define FLIGHT_RECORD_MEDIA_STOP 7
+#define FLIGHT_RECORD_MEDIA_START 8
+
+#define FLIGHT_RECORDER_MAGIC "SDFLIGHT"
+#define FLIGHT_RECORDER_VERSION 1
+
+struct FlightRecord {
+	// 0 while the record is being written, otherwise the claim number + 1.
+	uint64_t sequence;
+	uint64_t timestamp;
+	uint32_t type;
+	uint32_t reserved;
+	double value;
+	char source[32];
+};
+
+struct FlightRecorderHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint64_t capacity;
+	uint64_t next;
+	uint8_t reserved[32];
+};
+
+static_assert(sizeof(FlightRecord) == 64, "flight records must stay fixed size");
+static_assert(sizeof(FlightRecorderHeader) == 64, "flight recorder header must stay fixed size");
+
+static inline std::atomic<uint64_t> &flight_recorder_atomic(const uint64_t &value)
+{
+	return *reinterpret_cast<std::atomic<uint64_t> *>(const_cast<uint64_t *>(&value));
+}
+
+static inline uint64_t flight_recorder_size(uint64_t capacity)
+{
+	return sizeof(FlightRecorderHeader) + capacity * sizeof(FlightRecord);
+}
+
+static inline bool flight_recorder_valid_header(const FlightRecorderHeader *header, uint64_t size)
+{
+	return memcmp(header->magic, FLIGHT_RECORDER_MAGIC, sizeof(header->magic)) == 0 &&
+	       header->version == FLIGHT_RECORDER_VERSION && header->recordSize == sizeof(FlightRecord) &&
+	       header->capacity > 0 && header->capacity <= (size - sizeof(FlightRecorderHeader)) / sizeof(FlightRecord);
+}
+
+// Sets up an empty ring in map, which holds flight_recorder_size(capacity)
+// bytes.
+static inline void flight_recorder_init(uint8_t *map, uint64_t capacity)
+{
+	memset(map, 0, (size_t)flight_recorder_size(capacity));
+	auto header = reinterpret_cast<FlightRecorderHeader *>(map);
+	memcpy(header->magic, FLIGHT_RECORDER_MAGIC, sizeof(header->magic));
+	header->version = FLIGHT_RECORDER_VERSION;
+	header->recordSize = sizeof(FlightRecord);
+	header->capacity = capacity;
+}
+
+// Writers claim a slot with one atomic increment and never block. The slot
+// sequence is 0 while it is written, readers skip it then.
+static inline void flight_recorder_write(FlightRecorderHeader *header, FlightRecord *ring, uint64_t capacity, uint32_t type,
+					 const char *source, double value, uint64_t timestamp)
+{
+	const uint64_t claim = flight_recorder_atomic(header->next).fetch_add(1, std::memory_order_relaxed);
+	FlightRecord &record = ring[claim % capacity];
+	auto &sequence = flight_recorder_atomic(record.sequence);
+	sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	record.timestamp = timestamp;
+	record.type = type;
+	record.reserved = 0;
+	record.value = value;
+	size_t length = 0;
+	for (; source && length < sizeof(record.source) - 1 && source[length]; length++)
+		record.source[length] = source[length];
+	memset(record.source + length, 0, sizeof(record.source) - length);
+	sequence.store(claim + 1, std::memory_order_release);
+}
+
+// Copies the complete records of a ring, oldest first. The ring can be live:
+// a record is only kept when its sequence is set, belongs to its slot and did
+// not change while it was copied. Returns false when map is not a ring.
+static inline bool flight_recorder_read(const uint8_t *map, uint64_t size, std::vector<FlightRecord> &records)
+{
+	records.clear();
+	if (size < sizeof(FlightRecorderHeader))
+		return false;
+	auto header = reinterpret_cast<const FlightRecorderHeader *>(map);
+	if (!flight_recorder_valid_header(header, size))
+		return false;
+	const uint64_t capacity = header->capacity;
+	auto ring = reinterpret_cast<const FlightRecord *>(map + sizeof(FlightRecorderHeader));
+	records.reserve((size_t)capacity);
+	for (uint64_t i = 0; i < capacity; i++) {
+		const auto &sequence = flight_recorder_atomic(ring[i].sequence);
+		const uint64_t before = sequence.load(std::memory_order_acquire);
+		if (!before || (before - 1) % capacity != i)
+			continue;
+		FlightRecord record;
+		memcpy(&record, &ring[i], sizeof(record));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence.load(std::memory_order_relaxed) != before || record.sequence != before)
+			continue;
+		record.source[sizeof(record.source) - 1] = '\0';
+		records.push_back(record);
+	}
+	std::sort(records.begin(), records.end(),
+		  [](const FlightRecord &a, const FlightRecord &b) { return a.sequence < b.sequence; });
+	return true;
+}
+
+static inline const char *flight_record_type_name(uint32_t type)
+{
+	switch (type) {
+	case FLIGHT_RECORD_TALLY:
+		return "tally";
+	case FLIGHT_RECORD_LEVEL:
+		return "level";
+	case FLIGHT_RECORD_VOLUME:
+		return "volume";
+	case FLIGHT_RECORD_MUTE:
+		return "mute";
+	case FLIGHT_RECORD_MEDIA_PLAY:
+		return "media_play";
+	case FLIGHT_RECORD_MEDIA_PAUSE:
+		return "media_pause";
+	case FLIGHT_RECORD_MEDIA_STOP:
+		return "media_stop";
+	case FLIGHT_RECORD_MEDIA_START:
+		return "media_start";
+	default:
+		return "unknown";
+	}
+}
+
+static inline bool flight_recorder_write_csv(FILE *out, const std::vector<FlightRecord> &records)
+{
+	fputs("sequence,timestamp_ns,type,source,value\n", out);
+	for (const auto &record : records) {
+		fprintf(out, "%llu,%llu,%s,\"", (unsigned long long)record.sequence, (unsigned long long)record.timestamp,
+			flight_record_type_name(record.type));
+		for (size_t i = 0; i < sizeof(record.source) && record.source[i]; i++) {
+			if (record.source[i] == '"')
+				fputc('"', out);
+			fputc(record.source[i], out);
+		}
+		fprintf(out, "\",%.9g\n", record.value);
+	}
+	return !ferror(out);
+}
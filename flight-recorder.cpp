@@ -0,0 +1,112 @@
+#include "flight-recorder.hpp"
+
+#include <obs-module.h>
+#include <QFile>
+#include <thread>
+#include <vector>
+
+#include <util/platform.h>
+
+QFile *FlightRecorder::file = nullptr;
+FlightRecorderHeader *FlightRecorder::header = nullptr;
+uint64_t FlightRecorder::capacity = 0;
+std::atomic<FlightRecord *> FlightRecorder::records{nullptr};
+std::atomic<int> FlightRecorder::writers{0};
+
+QString FlightRecorder::DefaultPath()
+{
+	char *dir = obs_module_config_path("");
+	os_mkdirs(dir);
+	bfree(dir);
+	char *path = obs_module_config_path("flight-recorder.bin");
+	QString result = QString::fromUtf8(path);
+	bfree(path);
+	return result;
+}
+
+bool FlightRecorder::Open(const QString &path)
+{
+	if (IsOpen())
+		return true;
+
+	auto f = new QFile(path);
+	const qint64 size = (qint64)flight_recorder_size(FLIGHT_RECORDER_CAPACITY);
+	if (!f->open(QIODevice::ReadWrite)) {
+		blog(LOG_WARNING, "[Source Dock] flight recorder failed to open '%s'", path.toUtf8().constData());
+		delete f;
+		return false;
+	}
+	// Keep the records of an earlier session when the layout matches.
+	bool keep = false;
+	if (f->size() == size) {
+		FlightRecorderHeader existing;
+		keep = f->read((char *)&existing, sizeof(existing)) == sizeof(existing) &&
+		       flight_recorder_valid_header(&existing, (uint64_t)size) && existing.capacity == FLIGHT_RECORDER_CAPACITY;
+	}
+	if (!keep && !f->resize(size)) {
+		blog(LOG_WARNING, "[Source Dock] flight recorder failed to resize '%s'", path.toUtf8().constData());
+		delete f;
+		return false;
+	}
+	uchar *map = f->map(0, size);
+	if (!map) {
+		blog(LOG_WARNING, "[Source Dock] flight recorder failed to map '%s'", path.toUtf8().constData());
+		delete f;
+		return false;
+	}
+	if (!keep)
+		flight_recorder_init(map, FLIGHT_RECORDER_CAPACITY);
+	auto h = reinterpret_cast<FlightRecorderHeader *>(map);
+	file = f;
+	header = h;
+	capacity = h->capacity;
+	records.store(reinterpret_cast<FlightRecord *>(map + sizeof(FlightRecorderHeader)), std::memory_order_release);
+	blog(LOG_INFO, "[Source Dock] flight recorder writing to '%s'", path.toUtf8().constData());
+	return true;
+}
+
+void FlightRecorder::Close()
+{
+	// Sequentially consistent, pairs with the writer count in Record.
+	if (!records.exchange(nullptr))
+		return;
+	// Writers that loaded the old pointer finish within a few nanoseconds.
+	while (writers.load() != 0)
+		std::this_thread::yield();
+	file->unmap(reinterpret_cast<uchar *>(header));
+	file->close();
+	delete file;
+	file = nullptr;
+	header = nullptr;
+}
+
+void FlightRecorder::Record(uint32_t type, const char *source, double value)
+{
+	writers.fetch_add(1);
+	if (FlightRecord *ring = records.load())
+		flight_recorder_write(header, ring, capacity, type, source, value, os_gettime_ns());
+	writers.fetch_sub(1, std::memory_order_release);
+}
+
+bool FlightRecorder::ExportCsv(const QString &ringPath, const QString &csvPath)
+{
+	QFile ring(ringPath);
+	if (!ring.open(QIODevice::ReadOnly))
+		return false;
+	const qint64 size = ring.size();
+	uchar *map = size > 0 ? ring.map(0, size) : nullptr;
+	if (!map)
+		return false;
+	// Only complete records are copied, the ring can be live while exporting.
+	std::vector<FlightRecord> sorted;
+	const bool valid = flight_recorder_read(map, (uint64_t)size, sorted);
+	ring.unmap(map);
+	if (!valid)
+		return false;
+
+	FILE *csv = os_fopen(csvPath.toUtf8().constData(), "wb");
+	if (!csv)
+		return false;
+	const bool written = flight_recorder_write_csv(csv, sorted);
+	return fclose(csv) == 0 && written;
+}
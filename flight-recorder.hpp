@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+
+#include "flight-recorder-format.hpp"
+
+#define FLIGHT_RECORDER_CAPACITY 65536
+// Level records are written once per this many volume meter callbacks.
+#define FLIGHT_RECORDER_LEVEL_INTERVAL 25
+
+class QFile;
+
+// Appends fixed size records to a ring in a memory mapped file, so the last
+// events survive a crash. Recording never blocks and is safe from the audio
+// thread. The flight-recorder-dump tool reads the file without OBS.
+class FlightRecorder {
+	static QFile *file;
+	static FlightRecorderHeader *header;
+	static uint64_t capacity;
+	static std::atomic<FlightRecord *> records;
+	static std::atomic<int> writers;
+
+public:
+	static QString DefaultPath();
+
+	static bool Open(const QString &path);
+	static void Close();
+	static bool IsOpen() { return records.load(std::memory_order_relaxed) != nullptr; }
+
+	static void Record(uint32_t type, const char *source, double value);
+
+	// Writes the records of a ring file as CSV, oldest first.
+	static bool ExportCsv(const QString &ringPath, const QString &csvPath);
+};
@@ -0,0 +1,212 @@
+#include "level-history.hpp"
+#include "volume-meter.hpp"
+
+#include <obs-module.h>
+#include <QCursor>
+#include <QMenu>
+#include <QPainter>
+
+#include "util/platform.h"
+
+#define LEVEL_HISTORY_MINIMUM_LEVEL -60.0f
+#define LEVEL_HISTORY_WARNING_LEVEL -20.0f
+#define LEVEL_HISTORY_ERROR_LEVEL -9.0f
+
+static inline uint64_t current_bucket()
+{
+	return os_gettime_ns() / (LEVEL_HISTORY_BUCKET_MS * 1000000ULL);
+}
+
+LevelHistory::LevelHistory(QWidget *parent, obs_volmeter_t *obs_volmeter_)
+	: QWidget(parent),
+	  obs_volmeter(obs_volmeter_),
+	  buckets(new LevelHistoryBucket[LEVEL_HISTORY_BUCKETS])
+{
+	setAttribute(Qt::WA_OpaquePaintEvent, true);
+	setMinimumSize(130, 32);
+	setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
+	setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(this, &QWidget::customContextMenuRequested, this, &LevelHistory::ContextMenuRequested);
+
+	for (int i = 0; i < LEVEL_HISTORY_BUCKETS; i++)
+		buckets[i].index = 0;
+
+	updateTimerRef = VolumeMeter::GetUpdateTimer();
+	updateTimerRef->AddVolControl(this);
+}
+
+LevelHistory::~LevelHistory()
+{
+	updateTimerRef->RemoveVolControl(this);
+}
+
+void LevelHistory::setLevels(const float magnitude[MAX_AUDIO_CHANNELS], const float peak[MAX_AUDIO_CHANNELS])
+{
+	const uint64_t index = current_bucket();
+	QMutexLocker locker(&dataMutex);
+
+	LevelHistoryBucket &bucket = buckets[index % LEVEL_HISTORY_BUCKETS];
+	if (bucket.index != index) {
+		// First levels in this bucket, overwrite what was left from a previous lap.
+		bucket.index = index;
+		for (int channelNr = 0; channelNr < MAX_AUDIO_CHANNELS; channelNr++) {
+			bucket.peakMin[channelNr] = peak[channelNr];
+			bucket.peakMax[channelNr] = peak[channelNr];
+			bucket.magnitude[channelNr] = magnitude[channelNr];
+		}
+		return;
+	}
+	for (int channelNr = 0; channelNr < MAX_AUDIO_CHANNELS; channelNr++) {
+		if (peak[channelNr] < bucket.peakMin[channelNr])
+			bucket.peakMin[channelNr] = peak[channelNr];
+		if (peak[channelNr] > bucket.peakMax[channelNr])
+			bucket.peakMax[channelNr] = peak[channelNr];
+		if (magnitude[channelNr] > bucket.magnitude[channelNr])
+			bucket.magnitude[channelNr] = magnitude[channelNr];
+	}
+}
+
+void LevelHistory::SetSeconds(int seconds_)
+{
+	if (seconds_ < 10)
+		seconds_ = 10;
+	if (seconds_ > LEVEL_HISTORY_MAX_SECONDS)
+		seconds_ = LEVEL_HISTORY_MAX_SECONDS;
+	seconds = seconds_;
+	update();
+}
+
+void LevelHistory::ContextMenuRequested()
+{
+	QMenu menu;
+	for (int s : {10, 30, 60, 120}) {
+		auto a = menu.addAction(QString::fromUtf8(obs_module_text("LevelHistorySeconds")).arg(s),
+					[this, s]() { SetSeconds(s); });
+		a->setCheckable(true);
+		a->setChecked(seconds == s);
+	}
+	menu.exec(QCursor::pos());
+}
+
+int LevelHistory::getNrChannels()
+{
+	int nrChannels = obs_volmeter ? obs_volmeter_get_nr_channels(obs_volmeter) : 0;
+	if (!nrChannels) {
+		struct obs_audio_info oai;
+		obs_get_audio_info(&oai);
+		nrChannels = (oai.speakers == SPEAKERS_MONO) ? 1 : 2;
+	}
+	if (nrChannels > MAX_AUDIO_CHANNELS)
+		nrChannels = MAX_AUDIO_CHANNELS;
+	return nrChannels;
+}
+
+static inline int level_to_y(float level, int top, int laneHeight)
+{
+	if (!(level > LEVEL_HISTORY_MINIMUM_LEVEL))
+		return top + laneHeight;
+	if (level >= 0.0f)
+		return top;
+	return top + int(level / LEVEL_HISTORY_MINIMUM_LEVEL * laneHeight);
+}
+
+void LevelHistory::paintColumn(QPainter &painter, int x, int64_t column, double bucketsPerColumn, int nrChannels)
+{
+	const int laneHeight = (height() - (nrChannels - 1)) / nrChannels;
+	painter.fillRect(x, 0, 1, height(), palette().color(QPalette::ColorRole::Window));
+	if (column < 0 || laneHeight <= 0)
+		return;
+
+	// Decimate all buckets that fall into this pixel column to min/max.
+	uint64_t first = (uint64_t)(column * bucketsPerColumn);
+	uint64_t last = (uint64_t)((column + 1) * bucketsPerColumn);
+	if (last > first)
+		last--;
+
+	float peakMin[MAX_AUDIO_CHANNELS];
+	float peakMax[MAX_AUDIO_CHANNELS];
+	float magnitude[MAX_AUDIO_CHANNELS];
+	bool found = false;
+
+	QMutexLocker locker(&dataMutex);
+	for (uint64_t index = first; index <= last; index++) {
+		const LevelHistoryBucket &bucket = buckets[index % LEVEL_HISTORY_BUCKETS];
+		if (bucket.index != index)
+			continue;
+		for (int channelNr = 0; channelNr < nrChannels; channelNr++) {
+			if (!found || bucket.peakMin[channelNr] < peakMin[channelNr])
+				peakMin[channelNr] = bucket.peakMin[channelNr];
+			if (!found || bucket.peakMax[channelNr] > peakMax[channelNr])
+				peakMax[channelNr] = bucket.peakMax[channelNr];
+			if (!found || bucket.magnitude[channelNr] > magnitude[channelNr])
+				magnitude[channelNr] = bucket.magnitude[channelNr];
+		}
+		found = true;
+	}
+	locker.unlock();
+
+	if (!found)
+		return;
+
+	for (int channelNr = 0; channelNr < nrChannels; channelNr++) {
+		const int top = channelNr * (laneHeight + 1);
+		const int bottom = top + laneHeight;
+
+		const int magnitudeY = level_to_y(magnitude[channelNr], top, laneHeight);
+		if (magnitudeY < bottom)
+			painter.fillRect(x, magnitudeY, 1, bottom - magnitudeY, QColor(0x26, 0x7f, 0x26));
+
+		const int peakMaxY = level_to_y(peakMax[channelNr], top, laneHeight);
+		const int peakMinY = level_to_y(peakMin[channelNr], top, laneHeight);
+		if (peakMaxY >= bottom)
+			continue;
+
+		QColor color;
+		if (peakMax[channelNr] < LEVEL_HISTORY_WARNING_LEVEL)
+			color.setRgb(0x4c, 0xff, 0x4c);
+		else if (peakMax[channelNr] < LEVEL_HISTORY_ERROR_LEVEL)
+			color.setRgb(0xff, 0xff, 0x4c);
+		else
+			color.setRgb(0xff, 0x4c, 0x4c);
+		painter.fillRect(x, peakMaxY, 1, (peakMinY > peakMaxY ? peakMinY - peakMaxY : 1), color);
+	}
+}
+
+void LevelHistory::paintEvent(QPaintEvent *event)
+{
+	UNUSED_PARAMETER(event);
+	const int w = width();
+	const int h = height();
+	if (w <= 0 || h <= 0)
+		return;
+
+	const int nrChannels = getNrChannels();
+	const double bucketsPerColumn = double(seconds * 1000 / LEVEL_HISTORY_BUCKET_MS) / double(w);
+	const int64_t column = (int64_t)(current_bucket() / bucketsPerColumn);
+
+	// Only the columns that were added since the last paint get drawn,
+	// the rest of the cached image is shifted to the left.
+	int64_t firstColumn;
+	if (paintCache.size() != size() || paintCacheBucketsPerColumn != bucketsPerColumn ||
+	    paintCacheChannels != nrChannels || column - paintCacheColumn >= w || column < paintCacheColumn) {
+		paintCache = QPixmap(size());
+		paintCacheBucketsPerColumn = bucketsPerColumn;
+		paintCacheChannels = nrChannels;
+		firstColumn = column - w + 1;
+	} else {
+		const int shift = int(column - paintCacheColumn);
+		if (shift > 0)
+			paintCache.scroll(-shift, 0, paintCache.rect());
+		// The previous last column was still being filled, draw it again.
+		firstColumn = paintCacheColumn;
+	}
+	paintCacheColumn = column;
+
+	QPainter cachePainter(&paintCache);
+	for (int64_t c = firstColumn; c <= column; c++)
+		paintColumn(cachePainter, w - 1 - int(column - c), c, bucketsPerColumn, nrChannels);
+	cachePainter.end();
+
+	QPainter painter(this);
+	painter.drawPixmap(0, 0, paintCache);
+}
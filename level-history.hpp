@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QWidget>
+#include <QMutex>
+#include <QPixmap>
+#include <QSharedPointer>
+#include <memory>
+
+#include "obs.h"
+
+// Every bucket holds the levels of 50 ms, the ring holds 120 seconds.
+#define LEVEL_HISTORY_BUCKET_MS 50
+#define LEVEL_HISTORY_MAX_SECONDS 120
+#define LEVEL_HISTORY_BUCKETS (LEVEL_HISTORY_MAX_SECONDS * 1000 / LEVEL_HISTORY_BUCKET_MS)
+
+class VolumeMeterTimer;
+
+struct LevelHistoryBucket {
+	uint64_t index;
+	float peakMin[MAX_AUDIO_CHANNELS];
+	float peakMax[MAX_AUDIO_CHANNELS];
+	float magnitude[MAX_AUDIO_CHANNELS];
+};
+
+class LevelHistory : public QWidget {
+	Q_OBJECT
+
+private:
+	obs_volmeter_t *obs_volmeter;
+	QSharedPointer<VolumeMeterTimer> updateTimerRef;
+
+	QMutex dataMutex;
+	std::unique_ptr<LevelHistoryBucket[]> buckets;
+
+	int seconds = 30;
+	QPixmap paintCache;
+	int64_t paintCacheColumn = 0;
+	double paintCacheBucketsPerColumn = 0.0;
+	int paintCacheChannels = 0;
+
+	int getNrChannels();
+	void paintColumn(QPainter &painter, int x, int64_t column, double bucketsPerColumn, int nrChannels);
+
+private slots:
+	void ContextMenuRequested();
+
+public:
+	explicit LevelHistory(QWidget *parent = nullptr, obs_volmeter_t *obs_volmeter = nullptr);
+	~LevelHistory();
+
+	void setLevels(const float magnitude[MAX_AUDIO_CHANNELS], const float peak[MAX_AUDIO_CHANNELS]);
+
+	int GetSeconds() const { return seconds; }
+	void SetSeconds(int seconds);
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+};
@@ -1,4 +1,5 @@
 #include "media-control.hpp"
+#include "flight-recorder.hpp"
 #include <obs-module.h>
 #include <QToolTip>
 #include <QMainWindow>
@@ -171,7 +172,9 @@ void MediaControl::SetSource(OBSWeakSource weakSource_)
 
 void MediaControl::OBSMediaStopped(void *data, calldata_t *calldata)
 {
-	UNUSED_PARAMETER(calldata);
+	if (FlightRecorder::IsOpen())
+		FlightRecorder::Record(FLIGHT_RECORD_MEDIA_STOP,
+				       obs_source_get_name((obs_source_t *)calldata_ptr(calldata, "source")), 0.0);
 
 	MediaControl *media = static_cast<MediaControl *>(data);
 	QMetaObject::invokeMethod(media, "SetRestartState");
@@ -179,7 +182,9 @@ void MediaControl::OBSMediaStopped(void *data, calldata_t *calldata)
 
 void MediaControl::OBSMediaPlay(void *data, calldata_t *calldata)
 {
-	UNUSED_PARAMETER(calldata);
+	if (FlightRecorder::IsOpen())
+		FlightRecorder::Record(FLIGHT_RECORD_MEDIA_PLAY,
+				       obs_source_get_name((obs_source_t *)calldata_ptr(calldata, "source")), 0.0);
 
 	MediaControl *media = static_cast<MediaControl *>(data);
 	QMetaObject::invokeMethod(media, "SetPlayingState");
@@ -187,7 +192,9 @@ void MediaControl::OBSMediaPlay(void *data, calldata_t *calldata)
 
 void MediaControl::OBSMediaPause(void *data, calldata_t *calldata)
 {
-	UNUSED_PARAMETER(calldata);
+	if (FlightRecorder::IsOpen())
+		FlightRecorder::Record(FLIGHT_RECORD_MEDIA_PAUSE,
+				       obs_source_get_name((obs_source_t *)calldata_ptr(calldata, "source")), 0.0);
 
 	MediaControl *media = static_cast<MediaControl *>(data);
 	QMetaObject::invokeMethod(media, "SetPausedState");
@@ -195,7 +202,9 @@ void MediaControl::OBSMediaPause(void *data, calldata_t *calldata)
 
 void MediaControl::OBSMediaStarted(void *data, calldata_t *calldata)
 {
-	UNUSED_PARAMETER(calldata);
+	if (FlightRecorder::IsOpen())
+		FlightRecorder::Record(FLIGHT_RECORD_MEDIA_START,
+				       obs_source_get_name((obs_source_t *)calldata_ptr(calldata, "source")), 0.0);
 
 	MediaControl *media = static_cast<MediaControl *>(data);
 	QMetaObject::invokeMethod(media, "SetPlayingState");
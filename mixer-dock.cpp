@@ -0,0 +1,436 @@
+#include "mixer-dock.hpp"
+#include "volume-meter.hpp"
+#include "fader-law.hpp"
+
+#include <obs-frontend-api.h>
+#include <obs-module.h>
+#include <QCursor>
+#include <QDockWidget>
+#include <QMainWindow>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QPainter>
+#include <algorithm>
+
+#include "util/platform.h"
+
+#ifndef QT_UTF8
+#define QT_UTF8(str) QString::fromUtf8(str)
+#endif
+
+#define CLAMP(x, min, max) ((x) < (min) ? (min) : ((x) > (max) ? (max) : (x)))
+
+#define STRIP_WIDTH 56
+#define STRIP_SPACING 2
+#define STRIP_HEADER_HEIGHT 16
+#define STRIP_FOOTER_HEIGHT 36
+#define MUTE_SIZE 16
+#define FADER_WIDTH 12
+
+// Same as the VolumeMeter defaults. VolumeMeter is a widget with its own
+// volmeter, mutex and theme properties, the mixer paints every strip itself
+// so it stays a single widget however many sources it shows.
+#define MINIMUM_LEVEL -60.0f
+#define WARNING_LEVEL -20.0f
+#define ERROR_LEVEL -9.0f
+#define PEAK_DECAY_RATE 11.76f
+#define MAGNITUDE_INTEGRATION_TIME 0.3f
+#define PEAK_HOLD_DURATION 20.0f
+
+MixerDock::MixerDock(QString name, QWidget *parent) : QWidget(parent)
+{
+	setWindowTitle(name);
+	setObjectName(name);
+	setAttribute(Qt::WA_OpaquePaintEvent, true);
+	setMouseTracking(false);
+	setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(this, &QWidget::customContextMenuRequested, this, &MixerDock::ContextMenuRequested);
+	UpdateMinimumSize();
+
+	updateTimerRef = VolumeMeter::GetUpdateTimer();
+	updateTimerRef->AddVolControl(this);
+}
+
+MixerDock *MixerDock::Create(QString title, QMainWindow *window)
+{
+	auto mixer = new MixerDock(title, window);
+	auto t = title.toUtf8();
+	if (!obs_frontend_add_dock_by_id(t.constData(), t.constData(), mixer)) {
+		delete mixer;
+		return nullptr;
+	}
+	mixer_docks.push_back(mixer);
+	return mixer;
+}
+
+MixerDock::~MixerDock()
+{
+	updateTimerRef->RemoveVolControl(this);
+	ClearSources();
+}
+
+void MixerDock::OBSVolumeLevel(void *data, const float magnitude[MAX_AUDIO_CHANNELS], const float peak[MAX_AUDIO_CHANNELS],
+			       const float inputPeak[MAX_AUDIO_CHANNELS])
+{
+	UNUSED_PARAMETER(inputPeak);
+	auto strip = static_cast<MixerStrip *>(data);
+	uint64_t ts = os_gettime_ns();
+	QMutexLocker locker(&strip->mixer->levelsMutex);
+	strip->levels.lastUpdateTime = ts;
+	memcpy(strip->levels.magnitude, magnitude, sizeof(strip->levels.magnitude));
+	memcpy(strip->levels.peak, peak, sizeof(strip->levels.peak));
+}
+
+void MixerDock::UpdateMinimumSize()
+{
+	int count = (int)strips.size();
+	if (count < 1)
+		count = 1;
+	setMinimumSize(count * (STRIP_WIDTH + STRIP_SPACING), STRIP_HEADER_HEIGHT + STRIP_FOOTER_HEIGHT + 130);
+}
+
+void MixerDock::ResetLevels(MixerStrip *strip)
+{
+	strip->levels.lastUpdateTime = 0;
+	for (int channelNr = 0; channelNr < MAX_AUDIO_CHANNELS; channelNr++) {
+		strip->levels.magnitude[channelNr] = -M_INFINITE;
+		strip->levels.peak[channelNr] = -M_INFINITE;
+	}
+	ResetDisplayLevels(strip);
+}
+
+void MixerDock::ResetDisplayLevels(MixerStrip *strip)
+{
+	for (int channelNr = 0; channelNr < MAX_AUDIO_CHANNELS; channelNr++) {
+		strip->displayMagnitude[channelNr] = -M_INFINITE;
+		strip->displayPeak[channelNr] = -M_INFINITE;
+		strip->displayPeakHold[channelNr] = -M_INFINITE;
+		strip->displayPeakHoldLastUpdateTime[channelNr] = 0;
+	}
+}
+
+void MixerDock::AddSource(obs_source_t *source)
+{
+	if (!source || !(obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO))
+		return;
+	for (const auto &strip : strips) {
+		if (strip->source == source)
+			return;
+	}
+
+	auto strip = std::make_unique<MixerStrip>();
+	strip->mixer = this;
+	strip->source = source;
+	strip->name = QT_UTF8(obs_source_get_name(source));
+	ResetLevels(strip.get());
+	strip->volmeter = obs_volmeter_create(OBS_FADER_LOG);
+	obs_volmeter_attach_source(strip->volmeter, source);
+	obs_volmeter_add_callback(strip->volmeter, OBSVolumeLevel, strip.get());
+
+	QMutexLocker locker(&levelsMutex);
+	strips.push_back(std::move(strip));
+	locker.unlock();
+
+	UpdateMinimumSize();
+	update();
+}
+
+static bool add_scene_item_source(obs_scene_t *scene, obs_sceneitem_t *item, void *data)
+{
+	UNUSED_PARAMETER(scene);
+	auto mixer = static_cast<MixerDock *>(data);
+	if (obs_sceneitem_is_group(item))
+		obs_scene_enum_items(obs_group_from_source(obs_sceneitem_get_source(item)), add_scene_item_source, data);
+	else
+		mixer->AddSource(obs_sceneitem_get_source(item));
+	return true;
+}
+
+void MixerDock::AddCurrentSceneSources()
+{
+	obs_source_t *scene_source = obs_frontend_preview_program_mode_active() ? obs_frontend_get_current_preview_scene()
+										 : obs_frontend_get_current_scene();
+	if (!scene_source)
+		return;
+	obs_scene_enum_items(obs_scene_from_source(scene_source), add_scene_item_source, this);
+	obs_source_release(scene_source);
+}
+
+void MixerDock::RemoveSource(obs_source_t *source)
+{
+	for (auto it = strips.begin(); it != strips.end(); ++it) {
+		if ((*it)->source != source)
+			continue;
+		obs_volmeter_remove_callback((*it)->volmeter, OBSVolumeLevel, it->get());
+		obs_volmeter_destroy((*it)->volmeter);
+		QMutexLocker locker(&levelsMutex);
+		strips.erase(it);
+		locker.unlock();
+		UpdateMinimumSize();
+		update();
+		return;
+	}
+}
+
+void MixerDock::ClearSources()
+{
+	for (const auto &strip : strips) {
+		obs_volmeter_remove_callback(strip->volmeter, OBSVolumeLevel, strip.get());
+		obs_volmeter_destroy(strip->volmeter);
+	}
+	QMutexLocker locker(&levelsMutex);
+	strips.clear();
+	locker.unlock();
+	UpdateMinimumSize();
+	update();
+}
+
+std::vector<OBSSource> MixerDock::GetSources() const
+{
+	std::vector<OBSSource> sources;
+	sources.reserve(strips.size());
+	for (const auto &strip : strips)
+		sources.push_back(strip->source);
+	return sources;
+}
+
+void MixerDock::ContextMenuRequested(const QPoint &pos)
+{
+	QMenu menu;
+	auto addMenu = menu.addMenu(QT_UTF8(obs_module_text("AddSource")));
+	std::vector<OBSSource> audioSources;
+	obs_enum_sources(
+		[](void *data, obs_source_t *source) {
+			if (obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO)
+				static_cast<std::vector<OBSSource> *>(data)->push_back(source);
+			return true;
+		},
+		&audioSources);
+	for (const auto &source : audioSources)
+		addMenu->addAction(QT_UTF8(obs_source_get_name(source)), [this, source]() { AddSource(source); });
+	menu.addAction(QT_UTF8(obs_module_text("AddCurrentSceneSources")), [this]() { AddCurrentSceneSources(); });
+
+	const int index = StripAt(pos);
+	if (index >= 0) {
+		OBSSource source = strips[index]->source;
+		menu.addAction(QT_UTF8(obs_module_text("RemoveSource")).arg(strips[index]->name),
+			       [this, source]() { RemoveSource(source); });
+	}
+	menu.addSeparator();
+	menu.addAction(QT_UTF8(obs_module_text("Clear")), [this]() { ClearSources(); });
+	menu.exec(QCursor::pos());
+}
+
+QRect MixerDock::StripRect(int index) const
+{
+	return QRect(index * (STRIP_WIDTH + STRIP_SPACING), 0, STRIP_WIDTH, height());
+}
+
+QRect MixerDock::FaderRect(int index) const
+{
+	const QRect r = StripRect(index);
+	return QRect(r.right() - FADER_WIDTH - 2, r.top() + STRIP_HEADER_HEIGHT + 4, FADER_WIDTH,
+		     r.height() - STRIP_HEADER_HEIGHT - STRIP_FOOTER_HEIGHT - 8);
+}
+
+QRect MixerDock::MuteRect(int index) const
+{
+	const QRect r = StripRect(index);
+	return QRect(r.left() + (r.width() - MUTE_SIZE) / 2, r.bottom() - MUTE_SIZE - 2, MUTE_SIZE, MUTE_SIZE);
+}
+
+int MixerDock::StripAt(const QPoint &pos) const
+{
+	const int index = pos.x() / (STRIP_WIDTH + STRIP_SPACING);
+	if (index < 0 || index >= (int)strips.size() || !StripRect(index).contains(pos))
+		return -1;
+	return index;
+}
+
+void MixerDock::SetVolumeFromFader(int index, int y)
+{
+	const QRect fader = FaderRect(index);
+	if (fader.height() <= 0)
+		return;
+	float def = float(fader.bottom() - y) / float(fader.height());
+	def = CLAMP(def, 0.0f, 1.0f);
+	obs_source_set_volume(strips[index]->source, obs_db_to_mul(fader_def_to_db(FADER_LAW_LOG, def)));
+}
+
+void MixerDock::mousePressEvent(QMouseEvent *event)
+{
+	if (event->button() != Qt::LeftButton) {
+		QWidget::mousePressEvent(event);
+		return;
+	}
+	const int index = StripAt(event->pos());
+	if (index < 0)
+		return;
+	if (MuteRect(index).contains(event->pos())) {
+		obs_source_t *source = strips[index]->source;
+		obs_source_set_muted(source, !obs_source_muted(source));
+		update();
+	} else if (FaderRect(index).adjusted(-4, -4, 4, 4).contains(event->pos())) {
+		dragStrip = index;
+		SetVolumeFromFader(index, event->pos().y());
+		update();
+	}
+}
+
+void MixerDock::mouseMoveEvent(QMouseEvent *event)
+{
+	if (dragStrip < 0 || dragStrip >= (int)strips.size())
+		return;
+	SetVolumeFromFader(dragStrip, event->pos().y());
+	update();
+}
+
+void MixerDock::mouseReleaseEvent(QMouseEvent *event)
+{
+	UNUSED_PARAMETER(event);
+	dragStrip = -1;
+}
+
+void MixerDock::CalculateBallistics(MixerStrip *strip, const MixerLevels &levels, uint64_t ts, float timeSinceLastRedraw)
+{
+	for (int channelNr = 0; channelNr < MAX_AUDIO_CHANNELS; channelNr++) {
+		const float peak = levels.peak[channelNr];
+		if (peak >= strip->displayPeak[channelNr] || isnan(strip->displayPeak[channelNr])) {
+			strip->displayPeak[channelNr] = peak;
+		} else {
+			float decay = PEAK_DECAY_RATE * timeSinceLastRedraw;
+			strip->displayPeak[channelNr] = CLAMP(strip->displayPeak[channelNr] - decay, peak, 0);
+		}
+
+		if (peak >= strip->displayPeakHold[channelNr] || !isfinite(strip->displayPeakHold[channelNr]) ||
+		    (ts - strip->displayPeakHoldLastUpdateTime[channelNr]) * 0.000000001 > PEAK_HOLD_DURATION) {
+			strip->displayPeakHold[channelNr] = peak;
+			strip->displayPeakHoldLastUpdateTime[channelNr] = ts;
+		}
+
+		if (!isfinite(strip->displayMagnitude[channelNr])) {
+			strip->displayMagnitude[channelNr] = levels.magnitude[channelNr];
+		} else {
+			float attack = (levels.magnitude[channelNr] - strip->displayMagnitude[channelNr]) *
+				       (timeSinceLastRedraw / MAGNITUDE_INTEGRATION_TIME) * 0.99f;
+			strip->displayMagnitude[channelNr] =
+				CLAMP(strip->displayMagnitude[channelNr] + attack, MINIMUM_LEVEL, 0);
+		}
+	}
+}
+
+static inline int level_to_position(float level, int height)
+{
+	if (!(level > MINIMUM_LEVEL))
+		return 0;
+	if (level >= 0.0f)
+		return height;
+	return int(height - level / MINIMUM_LEVEL * height);
+}
+
+void MixerDock::PaintStrip(QPainter &painter, int index, bool idle)
+{
+	MixerStrip *strip = strips[index].get();
+	const QRect r = StripRect(index);
+	const QRect fader = FaderRect(index);
+
+	painter.fillRect(r, palette().color(QPalette::ColorRole::Base));
+	painter.setPen(palette().color(QPalette::ColorRole::Text));
+	painter.drawText(QRect(r.left() + 2, r.top(), r.width() - 4, STRIP_HEADER_HEIGHT), Qt::AlignCenter,
+			 painter.fontMetrics().elidedText(strip->name, Qt::ElideRight, r.width() - 4));
+
+	// Vertical meter, one 3 pixel bar per channel like the vertical VolumeMeter.
+	int nrChannels = obs_volmeter_get_nr_channels(strip->volmeter);
+	if (nrChannels > MAX_AUDIO_CHANNELS)
+		nrChannels = MAX_AUDIO_CHANNELS;
+	const int meterHeight = fader.height();
+	const int meterBottom = fader.bottom();
+	const int warningPosition = level_to_position(WARNING_LEVEL, meterHeight);
+	const int errorPosition = level_to_position(ERROR_LEVEL, meterHeight);
+	for (int channelNr = 0; channelNr < nrChannels; channelNr++) {
+		const int x = r.left() + 4 + channelNr * 4;
+		painter.fillRect(x, meterBottom - warningPosition, 3, warningPosition, QColor(0x26, 0x7f, 0x26));
+		painter.fillRect(x, meterBottom - errorPosition, 3, errorPosition - warningPosition, QColor(0x7f, 0x7f, 0x26));
+		painter.fillRect(x, meterBottom - meterHeight, 3, meterHeight - errorPosition, QColor(0x7f, 0x26, 0x26));
+		if (idle)
+			continue;
+
+		const int peakPosition = level_to_position(strip->displayPeak[channelNr], meterHeight);
+		painter.fillRect(x, meterBottom - std::min(peakPosition, warningPosition), 3,
+				 std::min(peakPosition, warningPosition), QColor(0x4c, 0xff, 0x4c));
+		if (peakPosition > warningPosition)
+			painter.fillRect(x, meterBottom - std::min(peakPosition, errorPosition), 3,
+					 std::min(peakPosition, errorPosition) - warningPosition, QColor(0xff, 0xff, 0x4c));
+		if (peakPosition > errorPosition)
+			painter.fillRect(x, meterBottom - peakPosition, 3, peakPosition - errorPosition,
+					 QColor(0xff, 0x4c, 0x4c));
+
+		const int holdPosition = level_to_position(strip->displayPeakHold[channelNr], meterHeight);
+		if (holdPosition >= 3)
+			painter.fillRect(x, meterBottom - holdPosition, 3, 3,
+					 holdPosition > errorPosition     ? QColor(0xff, 0x4c, 0x4c)
+					 : holdPosition > warningPosition ? QColor(0xff, 0xff, 0x4c)
+									  : QColor(0x4c, 0xff, 0x4c));
+		const int magnitudePosition = level_to_position(strip->displayMagnitude[channelNr], meterHeight);
+		if (magnitudePosition >= 3)
+			painter.fillRect(x, meterBottom - magnitudePosition, 3, 3, Qt::black);
+	}
+
+	// Fader
+	const float mul = obs_source_get_volume(strip->source);
+	const float db = obs_mul_to_db(mul);
+	const int faderPosition = int(fader_db_to_def(FADER_LAW_LOG, db) * fader.height());
+	painter.fillRect(fader.left() + FADER_WIDTH / 2 - 1, fader.top(), 2, fader.height(),
+			 palette().color(QPalette::ColorRole::Mid));
+	// Scale next to the fader, placed with the same law as the fader.
+	for (float tickDb : {0.0f, -10.0f, -20.0f, -30.0f, -40.0f, -60.0f}) {
+		const int tickPosition = int(fader_db_to_def(FADER_LAW_LOG, tickDb) * fader.height());
+		painter.fillRect(fader.left() - 4, fader.bottom() - tickPosition, 3, 1, palette().color(QPalette::ColorRole::Mid));
+	}
+	painter.fillRect(fader.left(), fader.bottom() - faderPosition - 3, FADER_WIDTH, 6,
+			 palette().color(QPalette::ColorRole::Button));
+	painter.setPen(palette().color(QPalette::ColorRole::ButtonText));
+	painter.drawRect(fader.left(), fader.bottom() - faderPosition - 3, FADER_WIDTH - 1, 5);
+
+	// Footer with the volume in dB and the mute button
+	painter.setPen(palette().color(QPalette::ColorRole::Text));
+	const QString dbText = isfinite(db) ? QString::number(db, 'f', 1) : QStringLiteral("-inf");
+	painter.drawText(QRect(r.left(), r.bottom() - STRIP_FOOTER_HEIGHT + 1, r.width(), 14), Qt::AlignCenter, dbText);
+
+	const QRect muteRect = MuteRect(index);
+	const bool muted = obs_source_muted(strip->source);
+	painter.fillRect(muteRect, muted ? QColor(0xff, 0x4c, 0x4c) : palette().color(QPalette::ColorRole::Button));
+	painter.setPen(palette().color(QPalette::ColorRole::ButtonText));
+	painter.drawRect(muteRect.adjusted(0, 0, -1, -1));
+	painter.drawText(muteRect, Qt::AlignCenter, QStringLiteral("M"));
+}
+
+void MixerDock::paintEvent(QPaintEvent *event)
+{
+	UNUSED_PARAMETER(event);
+	uint64_t ts = os_gettime_ns();
+	float timeSinceLastRedraw = float((ts - lastRedrawTime) * 0.000000001);
+
+	QPainter painter(this);
+	painter.fillRect(rect(), palette().color(QPalette::ColorRole::Window));
+
+	// Strips are only added and removed on this thread, the lock is only
+	// needed for the levels.
+	paintLevels.resize(strips.size());
+	QMutexLocker locker(&levelsMutex);
+	for (size_t index = 0; index < strips.size(); index++)
+		paintLevels[index] = strips[index]->levels;
+	locker.unlock();
+
+	for (int index = 0; index < (int)strips.size(); index++) {
+		MixerStrip *strip = strips[index].get();
+		const bool idle = (ts - paintLevels[index].lastUpdateTime) * 0.000000001 > 0.5;
+		if (idle)
+			ResetDisplayLevels(strip);
+		else
+			CalculateBallistics(strip, paintLevels[index], ts, timeSinceLastRedraw);
+		PaintStrip(painter, index, idle);
+	}
+
+	lastRedrawTime = ts;
+}
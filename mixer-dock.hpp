@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QWidget>
+#include <QMutex>
+#include <QSharedPointer>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include <obs.hpp>
+
+class QMainWindow;
+class VolumeMeterTimer;
+class MixerDock;
+
+struct MixerLevels {
+	uint64_t lastUpdateTime;
+	float magnitude[MAX_AUDIO_CHANNELS];
+	float peak[MAX_AUDIO_CHANNELS];
+};
+
+struct MixerStrip {
+	MixerDock *mixer;
+	OBSSource source;
+	obs_volmeter_t *volmeter;
+	QString name;
+
+	// Written by the audio thread, protected by the mixer levels mutex.
+	MixerLevels levels;
+
+	// Only used while painting.
+	float displayMagnitude[MAX_AUDIO_CHANNELS];
+	float displayPeak[MAX_AUDIO_CHANNELS];
+	float displayPeakHold[MAX_AUDIO_CHANNELS];
+	uint64_t displayPeakHoldLastUpdateTime[MAX_AUDIO_CHANNELS];
+};
+
+class MixerDock : public QWidget {
+	Q_OBJECT
+
+private:
+	std::vector<std::unique_ptr<MixerStrip>> strips;
+	QMutex levelsMutex;
+	// Copy of the strip levels, taken at the start of a paint so the audio
+	// thread never waits for painting.
+	std::vector<MixerLevels> paintLevels;
+	QSharedPointer<VolumeMeterTimer> updateTimerRef;
+	uint64_t lastRedrawTime = 0;
+	int dragStrip = -1;
+
+	static void OBSVolumeLevel(void *data, const float magnitude[MAX_AUDIO_CHANNELS], const float peak[MAX_AUDIO_CHANNELS],
+				   const float inputPeak[MAX_AUDIO_CHANNELS]);
+
+	int StripAt(const QPoint &pos) const;
+	QRect StripRect(int index) const;
+	QRect FaderRect(int index) const;
+	QRect MuteRect(int index) const;
+	void SetVolumeFromFader(int index, int y);
+	void ResetLevels(MixerStrip *strip);
+	void ResetDisplayLevels(MixerStrip *strip);
+	void CalculateBallistics(MixerStrip *strip, const MixerLevels &levels, uint64_t ts, float timeSinceLastRedraw);
+	void PaintStrip(QPainter &painter, int index, bool idle);
+	void UpdateMinimumSize();
+
+private slots:
+	void ContextMenuRequested(const QPoint &pos);
+
+public:
+	explicit MixerDock(QString name, QWidget *parent = nullptr);
+	~MixerDock();
+
+	void AddSource(obs_source_t *source);
+	void AddCurrentSceneSources();
+	void RemoveSource(obs_source_t *source);
+	void ClearSources();
+	std::vector<OBSSource> GetSources() const;
+
+	static MixerDock *Create(QString title, QMainWindow *window);
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+	void mousePressEvent(QMouseEvent *event) override;
+	void mouseMoveEvent(QMouseEvent *event) override;
+	void mouseReleaseEvent(QMouseEvent *event) override;
+};
+
+inline std::list<MixerDock *> mixer_docks;
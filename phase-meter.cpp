@@ -0,0 +1,253 @@
+#include "phase-meter.hpp"
+#include "volume-meter.hpp"
+
+#include <obs-module.h>
+#include <QCursor>
+#include <QMenu>
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+#include <util/sse-intrin.h>
+
+#ifndef QT_UTF8
+#define QT_UTF8(str) QString::fromUtf8(str)
+#endif
+
+#ifndef M_SQRT1_2
+#define M_SQRT1_2 0.70710678118654752440
+#endif
+
+#define PHASE_BAR_HEIGHT 16
+#define PHASE_GONIOMETER_SIZE 160
+#define PHASE_FADE_FRAMES 40
+
+PhaseMeter::PhaseMeter(QWidget *parent) : QWidget(parent), block(PHASE_BLOCK_SIZE * 2)
+{
+	setAttribute(Qt::WA_OpaquePaintEvent, true);
+	setMinimumWidth(130);
+	setFixedHeight(PHASE_BAR_HEIGHT);
+	setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(this, &QWidget::customContextMenuRequested, this, &PhaseMeter::ContextMenuRequested);
+
+	points.reserve(PHASE_MAX_POINTS * 4);
+	paintPoints.reserve(PHASE_MAX_POINTS * 4);
+
+	AnalysisWorker::AddTask(this);
+	updateTimerRef = VolumeMeter::GetUpdateTimer();
+	updateTimerRef->AddVolControl(this);
+}
+
+PhaseMeter::~PhaseMeter()
+{
+	updateTimerRef->RemoveVolControl(this);
+	SetSource(nullptr);
+	AnalysisWorker::RemoveTask(this);
+}
+
+void PhaseMeter::SetSource(obs_source_t *source_)
+{
+	if (source_ == source)
+		return;
+	if (source)
+		obs_source_remove_audio_capture_callback(source, OBSAudioCapture, this);
+	stereo = false;
+	ring.Reset();
+
+	source = source_;
+	if (!source || (obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO) == 0)
+		return;
+
+	stereo = audio_output_get_channels(obs_get_audio()) >= 2;
+	obs_source_add_audio_capture_callback(source, OBSAudioCapture, this);
+}
+
+void PhaseMeter::SetGoniometer(bool enable)
+{
+	goniometer = enable;
+	setFixedHeight(goniometer ? PHASE_BAR_HEIGHT + PHASE_GONIOMETER_SIZE : PHASE_BAR_HEIGHT);
+	update();
+}
+
+void PhaseMeter::ContextMenuRequested()
+{
+	QMenu menu;
+	auto a = menu.addAction(QT_UTF8(obs_module_text("Goniometer")), [this]() { SetGoniometer(!goniometer); });
+	a->setCheckable(true);
+	a->setChecked(goniometer);
+	menu.exec(QCursor::pos());
+}
+
+void PhaseMeter::OBSAudioCapture(void *param, obs_source_t *source, const struct audio_data *audio_data, bool muted)
+{
+	UNUSED_PARAMETER(source);
+	UNUSED_PARAMETER(muted);
+	auto meter = static_cast<PhaseMeter *>(param);
+	if (!meter->stereo || !audio_data->data[0] || !audio_data->data[1])
+		return;
+
+	const float *l = (const float *)audio_data->data[0];
+	const float *r = (const float *)audio_data->data[1];
+	float interleaved[1024];
+	for (uint32_t start = 0; start < audio_data->frames; start += 512) {
+		const uint32_t frames = std::min(audio_data->frames - start, 512u);
+		for (uint32_t i = 0; i < frames; i++) {
+			interleaved[i * 2] = l[start + i];
+			interleaved[i * 2 + 1] = r[start + i];
+		}
+		meter->ring.Write(interleaved, frames * 2, audio_data->timestamp);
+	}
+}
+
+// Sums L*R, L*L and R*R over interleaved stereo samples, four floats
+// (two frames) per step.
+static void correlate_block(const float *samples, size_t frames, float &lr, float &ll, float &rr)
+{
+	__m128 sumCross = _mm_setzero_ps();
+	__m128 sumSquares = _mm_setzero_ps();
+	const size_t count = frames * 2;
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 v = _mm_loadu_ps(samples + i);
+		const __m128 swapped = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+		sumCross = _mm_add_ps(sumCross, _mm_mul_ps(v, swapped));
+		sumSquares = _mm_add_ps(sumSquares, _mm_mul_ps(v, v));
+	}
+
+	float cross[4];
+	float squares[4];
+	_mm_storeu_ps(cross, sumCross);
+	_mm_storeu_ps(squares, sumSquares);
+	// Every L*R product is in the cross sum twice.
+	lr = (cross[0] + cross[1] + cross[2] + cross[3]) * 0.5f;
+	ll = squares[0] + squares[2];
+	rr = squares[1] + squares[3];
+
+	for (; i + 2 <= count; i += 2) {
+		lr += samples[i] * samples[i + 1];
+		ll += samples[i] * samples[i];
+		rr += samples[i + 1] * samples[i + 1];
+	}
+}
+
+void PhaseMeter::Process(uint64_t ts)
+{
+	const float seconds = lastProcessTime ? float(ts - lastProcessTime) / 1000000000.0f : 0.0f;
+	lastProcessTime = ts;
+
+	const uint64_t written = ring.Written();
+	size_t frames = 0;
+	if (written > lastWritten)
+		frames = std::min((size_t)(written - lastWritten) / 2, (size_t)PHASE_BLOCK_SIZE);
+	else if (written < lastWritten)
+		frames = std::min((size_t)written / 2, (size_t)PHASE_BLOCK_SIZE);
+	lastWritten = written;
+
+	if (frames && !ring.ReadLatest(block.data(), frames * 2))
+		frames = 0;
+
+	float lr = 0.0f;
+	float ll = 0.0f;
+	float rr = 0.0f;
+	if (frames)
+		correlate_block(block.data(), frames, lr, ll, rr);
+
+	const float decay = expf(-seconds / PHASE_INTEGRATION_TIME);
+	sumLR = sumLR * decay + lr;
+	sumLL = sumLL * decay + ll;
+	sumRR = sumRR * decay + rr;
+
+	const float energy = sqrtf(sumLL * sumRR);
+	const bool signal = energy > 1e-10f;
+
+	QMutexLocker locker(&dataMutex);
+	hasSignal = signal;
+	correlation = signal ? std::clamp(sumLR / energy, -1.0f, 1.0f) : 0.0f;
+	if (!goniometer || !frames)
+		return;
+
+	// Decimate the block to a bounded number of points, rotated so mono is vertical.
+	const size_t step = std::max(frames / PHASE_MAX_POINTS, (size_t)1);
+	if (points.size() > PHASE_MAX_POINTS * 3)
+		points.clear();
+	for (size_t i = 0; i < frames; i += step) {
+		const float l = block[i * 2];
+		const float r = block[i * 2 + 1];
+		points.push_back({(l - r) * (float)M_SQRT1_2, (l + r) * (float)M_SQRT1_2});
+	}
+}
+
+void PhaseMeter::paintGoniometer(const QRect &rect)
+{
+	if (goniometerCache.size() != rect.size()) {
+		goniometerCache = QImage(rect.size(), QImage::Format_RGB32);
+		goniometerCache.fill(Qt::black);
+		idleFrames = PHASE_FADE_FRAMES;
+	}
+
+	if (paintPoints.empty() && idleFrames >= PHASE_FADE_FRAMES)
+		return;
+	idleFrames = paintPoints.empty() ? idleFrames + 1 : 0;
+
+	QPainter painter(&goniometerCache);
+	// Fade what was drawn before instead of clearing it.
+	painter.fillRect(goniometerCache.rect(), QColor(0, 0, 0, 40));
+
+	const float radius = float(std::min(rect.width(), rect.height())) / 2.0f;
+	const float centerX = float(rect.width()) / 2.0f;
+	const float centerY = float(rect.height()) / 2.0f;
+	painter.setPen(QColor(0x40, 0x40, 0x40));
+	painter.drawLine(QPointF(centerX, centerY - radius), QPointF(centerX, centerY + radius));
+	painter.drawLine(QPointF(centerX - radius, centerY), QPointF(centerX + radius, centerY));
+
+	std::vector<QPointF> scaled;
+	scaled.reserve(paintPoints.size());
+	for (const auto &p : paintPoints)
+		scaled.emplace_back(centerX + p.side * radius, centerY - p.mid * radius);
+	painter.setPen(QColor(0x4c, 0xff, 0x4c));
+	painter.drawPoints(scaled.data(), (int)scaled.size());
+}
+
+void PhaseMeter::paintEvent(QPaintEvent *event)
+{
+	UNUSED_PARAMETER(event);
+	const int w = width();
+	if (w <= 0)
+		return;
+
+	dataMutex.lock();
+	const float currentCorrelation = correlation;
+	const bool currentSignal = hasSignal;
+	paintPoints.swap(points);
+	points.clear();
+	dataMutex.unlock();
+
+	QPainter painter(this);
+	const QRect bar(0, 0, w, PHASE_BAR_HEIGHT);
+	painter.fillRect(bar, palette().color(QPalette::ColorRole::Window));
+
+	const int center = w / 2;
+	if (currentSignal) {
+		const int x = center + int(currentCorrelation * float(w / 2 - 1));
+		QColor color;
+		if (currentCorrelation < 0.0f)
+			color.setRgb(0xff, 0x4c, 0x4c);
+		else if (currentCorrelation < 0.3f)
+			color.setRgb(0xff, 0xff, 0x4c);
+		else
+			color.setRgb(0x4c, 0xff, 0x4c);
+		painter.fillRect(std::min(x, center), 3, std::abs(x - center) + 1, PHASE_BAR_HEIGHT - 6, color);
+	}
+	painter.setPen(palette().color(QPalette::ColorRole::WindowText));
+	for (int tick = 0; tick <= 4; tick++) {
+		const int x = tick * (w - 1) / 4;
+		painter.drawLine(x, tick == 2 ? 0 : PHASE_BAR_HEIGHT - 4, x, PHASE_BAR_HEIGHT - 1);
+	}
+
+	if (!goniometer)
+		return;
+
+	const QRect rect(0, PHASE_BAR_HEIGHT, w, height() - PHASE_BAR_HEIGHT);
+	paintGoniometer(rect);
+	painter.drawImage(rect.topLeft(), goniometerCache);
+}
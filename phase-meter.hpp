@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWidget>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <obs.hpp>
+
+#include "analysis-worker.hpp"
+#include "audio-ring.hpp"
+
+#define PHASE_RING_SIZE 16384
+#define PHASE_BLOCK_SIZE 4096
+#define PHASE_MAX_POINTS 256
+#define PHASE_INTEGRATION_TIME 0.3f
+
+class VolumeMeterTimer;
+
+struct PhasePoint {
+	float side;
+	float mid;
+};
+
+class PhaseMeter : public QWidget, public AnalysisTask {
+	Q_OBJECT
+
+private:
+	OBSSource source;
+	QSharedPointer<VolumeMeterTimer> updateTimerRef;
+	std::atomic<bool> goniometer{false};
+
+	// Written by the audio thread, interleaved left and right.
+	AudioRing ring{PHASE_RING_SIZE * 2};
+	std::atomic<bool> stereo{false};
+
+	// Only used on the analysis thread.
+	std::vector<float> block;
+	uint64_t lastWritten = 0;
+	uint64_t lastProcessTime = 0;
+	float sumLR = 0.0f;
+	float sumLL = 0.0f;
+	float sumRR = 0.0f;
+
+	QMutex dataMutex;
+	float correlation = 0.0f;
+	bool hasSignal = false;
+	std::vector<PhasePoint> points;
+
+	// Only used while painting.
+	QImage goniometerCache;
+	std::vector<PhasePoint> paintPoints;
+	int idleFrames = 0;
+
+	static void OBSAudioCapture(void *param, obs_source_t *source, const struct audio_data *audio_data, bool muted);
+
+	void paintGoniometer(const QRect &rect);
+
+private slots:
+	void ContextMenuRequested();
+
+public:
+	explicit PhaseMeter(QWidget *parent = nullptr);
+	~PhaseMeter();
+
+	void SetSource(obs_source_t *source);
+
+	bool GetGoniometer() const { return goniometer; }
+	void SetGoniometer(bool enable);
+
+	void Process(uint64_t ts) override;
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+};
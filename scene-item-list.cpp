@@ -0,0 +1,402 @@
+#include "scene-item-list.hpp"
+#include "source-dock.hpp"
+
+#include <obs-frontend-api.h>
+#include <obs-module.h>
+#include <QComboBox>
+#include <QLineEdit>
+#include <QListView>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPushButton>
+#include <QStyleOption>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <unordered_set>
+
+#ifndef QT_UTF8
+#define QT_UTF8(str) QString::fromUtf8(str)
+#endif
+
+#define SCENE_ITEM_BUTTON_SIZE 16
+#define SCENE_ITEM_BUTTON_SPACING 4
+#define SCENE_ITEM_INDENT 16
+#define SCENE_ITEM_LAYOUT_BATCH 256
+
+#define SCENE_ITEM_BUTTON_PROPERTIES 0
+#define SCENE_ITEM_BUTTON_FILTERS 1
+#define SCENE_ITEM_BUTTON_VISIBILITY 2
+#define SCENE_ITEM_BUTTON_COUNT 3
+
+#define SCENE_ITEM_FILTER_ALL 0
+#define SCENE_ITEM_FILTER_VISIBLE 1
+#define SCENE_ITEM_FILTER_HIDDEN 2
+
+SceneItemModel::SceneItemModel(QObject *parent) : QAbstractListModel(parent) {}
+
+int SceneItemModel::rowCount(const QModelIndex &parent) const
+{
+	return parent.isValid() ? 0 : (int)rows.size();
+}
+
+QVariant SceneItemModel::data(const QModelIndex &index, int role) const
+{
+	const SceneItemRow *row = Row(index.row());
+	if (!row)
+		return QVariant();
+	if (role == Qt::DisplayRole || role == Qt::ToolTipRole)
+		return row->name;
+	return QVariant();
+}
+
+const SceneItemRow *SceneItemModel::Row(int row) const
+{
+	if (row < 0 || row >= (int)rows.size())
+		return nullptr;
+	return &rows[row];
+}
+
+std::vector<int> SceneItemModel::RowsWithId(int64_t id) const
+{
+	std::vector<int> result;
+	const auto range = rowsById.equal_range(id);
+	for (auto it = range.first; it != range.second; ++it)
+		result.push_back(it->second);
+	return result;
+}
+
+std::vector<obs_source_t *> SceneItemModel::Groups() const
+{
+	std::vector<obs_source_t *> groups;
+	for (const auto &row : rows) {
+		if (row.flags & SCENE_ITEM_GROUP)
+			groups.push_back(obs_sceneitem_get_source(row.item));
+	}
+	return groups;
+}
+
+void SceneItemModel::UpdateRow(int row, SceneItemRow &next)
+{
+	SceneItemRow &current = rows[row];
+	if (current.depth == next.depth && current.flags == next.flags && current.name == next.name)
+		return;
+	current.depth = next.depth;
+	current.flags = next.flags;
+	current.name = std::move(next.name);
+	current.filterKey = std::move(next.filterKey);
+	const QModelIndex changed = index(row);
+	emit dataChanged(changed, changed);
+}
+
+void SceneItemModel::SetScene(obs_scene_t *scene)
+{
+	snapshot_scene(scene, SCENE_SNAPSHOT_GROUPS | SCENE_SNAPSHOT_CONFIGURABLE, snapshot);
+	std::vector<SceneItemRow> next;
+	next.reserve(snapshot.size());
+	for (const auto &entry : snapshot) {
+		QString name = QT_UTF8(obs_source_get_name(entry.source));
+		QString filterKey = name.toLower();
+		filterKey += '\n';
+		filterKey += QT_UTF8(obs_source_get_display_name(obs_source_get_id(entry.source))).toLower();
+		next.push_back({OBSSceneItem(entry.item), entry.id, entry.depth, entry.flags, std::move(name),
+				std::move(filterKey)});
+	}
+
+	std::unordered_set<obs_sceneitem_t *> keep;
+	keep.reserve(next.size());
+	for (const auto &row : next)
+		keep.insert(row.item);
+
+	// Remove rows that are gone, one call per consecutive run.
+	for (int last = (int)rows.size() - 1; last >= 0;) {
+		if (keep.count(rows[last].item)) {
+			last--;
+			continue;
+		}
+		int first = last;
+		while (first > 0 && !keep.count(rows[first - 1].item))
+			first--;
+		beginRemoveRows(QModelIndex(), first, last);
+		rows.erase(rows.begin() + first, rows.begin() + last + 1);
+		endRemoveRows();
+		last = first - 1;
+	}
+
+	// The remaining rows keep their relative order unless they moved, walk
+	// the new tree and move or insert where it differs.
+	for (int i = 0; i < (int)next.size(); i++) {
+		if (i < (int)rows.size() && rows[i].item == next[i].item) {
+			UpdateRow(i, next[i]);
+			continue;
+		}
+		auto found = std::find_if(rows.begin() + std::min(i, (int)rows.size()), rows.end(),
+					  [&](const SceneItemRow &row) { return row.item == next[i].item; });
+		if (found == rows.end()) {
+			beginInsertRows(QModelIndex(), i, i);
+			rows.insert(rows.begin() + i, std::move(next[i]));
+			endInsertRows();
+			continue;
+		}
+		const int from = (int)(found - rows.begin());
+		beginMoveRows(QModelIndex(), from, from, QModelIndex(), i);
+		SceneItemRow moved = std::move(*found);
+		rows.erase(found);
+		rows.insert(rows.begin() + i, std::move(moved));
+		endMoveRows();
+		UpdateRow(i, next[i]);
+	}
+	IndexRows();
+}
+
+void SceneItemModel::IndexRows()
+{
+	rowsById.clear();
+	rowsById.reserve(rows.size());
+	for (int i = 0; i < (int)rows.size(); i++)
+		rowsById.emplace(rows[i].id, i);
+}
+
+void SceneItemModel::Clear()
+{
+	if (rows.empty())
+		return;
+	beginResetModel();
+	rows.clear();
+	rowsById.clear();
+	endResetModel();
+}
+
+void SceneItemModel::VisibilityChanged(int64_t id)
+{
+	const auto range = rowsById.equal_range(id);
+	for (auto it = range.first; it != range.second; ++it) {
+		SceneItemRow &row = rows[it->second];
+		const uint32_t flags = obs_sceneitem_visible(row.item) ? row.flags | SCENE_ITEM_VISIBLE
+								       : row.flags & ~SCENE_ITEM_VISIBLE;
+		if (row.flags == flags)
+			continue;
+		row.flags = flags;
+		const QModelIndex changed = index(it->second);
+		emit dataChanged(changed, changed);
+	}
+}
+
+SceneItemDelegate::SceneItemDelegate(QWidget *parent)
+	: QStyledItemDelegate(parent),
+	  propertiesPrototype(new QPushButton(parent)),
+	  filtersPrototype(new QPushButton(parent)),
+	  visibilityPrototype(new VisibilityCheckBox(parent))
+{
+	propertiesPrototype->setObjectName(QStringLiteral("sourcePropertiesButton"));
+	filtersPrototype->setObjectName(QStringLiteral("sourceFiltersButton"));
+	visibilityPrototype->setStyleSheet("background: none");
+	propertiesPrototype->setVisible(false);
+	filtersPrototype->setVisible(false);
+	visibilityPrototype->setVisible(false);
+}
+
+QRect SceneItemDelegate::ButtonRect(const QRect &row, int button)
+{
+	const int right = row.right() - (SCENE_ITEM_BUTTON_COUNT - 1 - button) *
+						(SCENE_ITEM_BUTTON_SIZE + SCENE_ITEM_BUTTON_SPACING);
+	return QRect(right - SCENE_ITEM_BUTTON_SIZE + 1, row.top() + (row.height() - SCENE_ITEM_BUTTON_SIZE) / 2,
+		     SCENE_ITEM_BUTTON_SIZE, SCENE_ITEM_BUTTON_SIZE);
+}
+
+void SceneItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	const SceneItemRow *row = static_cast<const SceneItemModel *>(index.model())->Row(index.row());
+	if (!row)
+		return;
+
+	QStyleOptionViewItem textOption(option);
+	initStyleOption(&textOption, index);
+	textOption.rect.setLeft(option.rect.left() + row->depth * SCENE_ITEM_INDENT);
+	textOption.rect.setRight(ButtonRect(option.rect, 0).left() - SCENE_ITEM_BUTTON_SPACING);
+	QStyledItemDelegate::paint(painter, textOption, index);
+
+	propertiesPrototype->ensurePolished();
+	filtersPrototype->ensurePolished();
+	visibilityPrototype->ensurePolished();
+
+	if (row->flags & SCENE_ITEM_CONFIGURABLE)
+		propertiesPrototype->icon().paint(painter, ButtonRect(option.rect, SCENE_ITEM_BUTTON_PROPERTIES));
+	filtersPrototype->icon().paint(painter, ButtonRect(option.rect, SCENE_ITEM_BUTTON_FILTERS));
+
+	QStyleOptionButton visibility;
+	visibility.initFrom(visibilityPrototype);
+	visibility.rect = ButtonRect(option.rect, SCENE_ITEM_BUTTON_VISIBILITY);
+	visibility.state |= QStyle::State_Enabled | ((row->flags & SCENE_ITEM_VISIBLE) ? QStyle::State_On : QStyle::State_Off);
+	visibilityPrototype->style()->drawPrimitive(QStyle::PE_IndicatorCheckBox, &visibility, painter,
+						    visibilityPrototype);
+}
+
+QSize SceneItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+	UNUSED_PARAMETER(index);
+	return QSize(option.rect.width(), std::max(option.fontMetrics.height(), SCENE_ITEM_BUTTON_SIZE) + 4);
+}
+
+bool SceneItemDelegate::editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+				    const QModelIndex &index)
+{
+	if (event->type() != QEvent::MouseButtonRelease)
+		return QStyledItemDelegate::editorEvent(event, model, option, index);
+	auto mouseEvent = static_cast<QMouseEvent *>(event);
+	if (mouseEvent->button() != Qt::LeftButton)
+		return false;
+	const SceneItemRow *row = static_cast<const SceneItemModel *>(model)->Row(index.row());
+	if (!row)
+		return false;
+
+	const QPoint pos = mouseEvent->position().toPoint();
+	obs_source_t *source = obs_sceneitem_get_source(row->item);
+	if ((row->flags & SCENE_ITEM_CONFIGURABLE) && ButtonRect(option.rect, SCENE_ITEM_BUTTON_PROPERTIES).contains(pos)) {
+		obs_frontend_open_source_properties(source);
+		return true;
+	}
+	if (ButtonRect(option.rect, SCENE_ITEM_BUTTON_FILTERS).contains(pos)) {
+		obs_frontend_open_source_filters(source);
+		return true;
+	}
+	if (ButtonRect(option.rect, SCENE_ITEM_BUTTON_VISIBILITY).contains(pos)) {
+		// The item_visible signal updates the row.
+		obs_sceneitem_set_visible(row->item, !obs_sceneitem_visible(row->item));
+		return true;
+	}
+	return false;
+}
+
+SceneItemList::SceneItemList(QWidget *parent)
+	: QWidget(parent),
+	  filterEdit(new QLineEdit),
+	  filterVisibility(new QComboBox),
+	  view(new QListView),
+	  model(new SceneItemModel(this))
+{
+	filterEdit->setPlaceholderText(QT_UTF8(obs_module_text("FilterItems")));
+	filterEdit->setClearButtonEnabled(true);
+	connect(filterEdit, &QLineEdit::textChanged, this, [this](const QString &text) {
+		const QString next = text.toLower();
+		// A longer filter can only match rows that match now.
+		const bool narrow = Filtering() && next.contains(filter);
+		filter = next;
+		if (!narrow) {
+			ApplyFilter();
+			return;
+		}
+		std::vector<int> previous;
+		previous.swap(shown);
+		for (int row : previous) {
+			if (Matches(row))
+				shown.push_back(row);
+			else
+				view->setRowHidden(row, true);
+		}
+	});
+
+	filterVisibility->addItem(QT_UTF8(obs_module_text("AllItems")), SCENE_ITEM_FILTER_ALL);
+	filterVisibility->addItem(QT_UTF8(obs_module_text("VisibleItems")), SCENE_ITEM_FILTER_VISIBLE);
+	filterVisibility->addItem(QT_UTF8(obs_module_text("HiddenItems")), SCENE_ITEM_FILTER_HIDDEN);
+	connect(filterVisibility, &QComboBox::currentIndexChanged, this, [this]() {
+		visibility = filterVisibility->currentData().toInt();
+		ApplyFilter();
+	});
+
+	view->setObjectName(QStringLiteral("vScrollArea"));
+	view->setFrameShape(QFrame::StyledPanel);
+	view->setFrameShadow(QFrame::Sunken);
+	view->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+	view->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+	view->setSelectionMode(QAbstractItemView::NoSelection);
+	view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	view->setFocusPolicy(Qt::NoFocus);
+	// Rows share one height, so the view only has to size the first row and
+	// lays out large scenes in batches between events.
+	view->setUniformItemSizes(true);
+	view->setLayoutMode(QListView::Batched);
+	view->setBatchSize(SCENE_ITEM_LAYOUT_BATCH);
+	view->setModel(model);
+	view->setItemDelegate(new SceneItemDelegate(view));
+
+	auto filterLayout = new QHBoxLayout;
+	filterLayout->setContentsMargins(0, 0, 0, 0);
+	filterLayout->addWidget(filterEdit, 1);
+	filterLayout->addWidget(filterVisibility);
+
+	auto layout = new QVBoxLayout;
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->addLayout(filterLayout);
+	layout->addWidget(view);
+	setLayout(layout);
+}
+
+bool SceneItemList::Filtering() const
+{
+	return !filter.isEmpty() || visibility != SCENE_ITEM_FILTER_ALL;
+}
+
+bool SceneItemList::Matches(int row) const
+{
+	const SceneItemRow *item = model->Row(row);
+	if (!item)
+		return false;
+	if (visibility != SCENE_ITEM_FILTER_ALL &&
+	    !!(item->flags & SCENE_ITEM_VISIBLE) != (visibility == SCENE_ITEM_FILTER_VISIBLE))
+		return false;
+	return filter.isEmpty() || item->filterKey.contains(filter);
+}
+
+void SceneItemList::FilterRow(int row)
+{
+	const bool match = Matches(row);
+	view->setRowHidden(row, !match);
+	auto it = std::lower_bound(shown.begin(), shown.end(), row);
+	const bool listed = it != shown.end() && *it == row;
+	if (match && !listed)
+		shown.insert(it, row);
+	else if (!match && listed)
+		shown.erase(it);
+}
+
+void SceneItemList::ApplyFilter()
+{
+	const bool filtering = Filtering();
+	shown.clear();
+	const int count = model->rowCount();
+	for (int row = 0; row < count; row++) {
+		const bool match = !filtering || Matches(row);
+		view->setRowHidden(row, !match);
+		if (match && filtering)
+			shown.push_back(row);
+	}
+}
+
+void SceneItemList::SetScene(obs_scene_t *scene)
+{
+	model->SetScene(scene);
+	// Rows moved, the shown rows are no longer valid.
+	if (Filtering())
+		ApplyFilter();
+}
+
+void SceneItemList::Clear()
+{
+	model->Clear();
+	shown.clear();
+}
+
+void SceneItemList::VisibilityChanged(int64_t id)
+{
+	model->VisibilityChanged(id);
+	if (visibility == SCENE_ITEM_FILTER_ALL)
+		return;
+	for (int row : model->RowsWithId(id))
+		FilterRow(row);
+}
+
+std::vector<obs_source_t *> SceneItemList::Groups() const
+{
+	return model->Groups();
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QStyledItemDelegate>
+#include <QWidget>
+#include <unordered_map>
+#include <vector>
+
+#include <obs.hpp>
+
+#include "scene-snapshot.hpp"
+
+class QComboBox;
+class QLineEdit;
+class QListView;
+class QPushButton;
+class VisibilityCheckBox;
+
+struct SceneItemRow {
+	OBSSceneItem item;
+	int64_t id;
+	int depth;
+	uint32_t flags;
+	QString name;
+	// Lowercase name and source type, separated by a newline.
+	QString filterKey;
+};
+
+// Flattened scene tree, top item first and group members below their group.
+// SetScene compares the new tree with the current rows and only emits the
+// row removes, moves, inserts and changes that are needed.
+class SceneItemModel : public QAbstractListModel {
+	Q_OBJECT
+
+private:
+	std::vector<SceneItemRow> rows;
+	std::vector<SceneItemEntry> snapshot;
+	// Item ids are only unique within their scene, members of a group can
+	// share an id with an item of the parent scene.
+	std::unordered_multimap<int64_t, int> rowsById;
+
+	void IndexRows();
+	void UpdateRow(int row, SceneItemRow &next);
+
+public:
+	explicit SceneItemModel(QObject *parent = nullptr);
+
+	int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex &index, int role) const override;
+
+	const SceneItemRow *Row(int row) const;
+	std::vector<int> RowsWithId(int64_t id) const;
+	std::vector<obs_source_t *> Groups() const;
+	void SetScene(obs_scene_t *scene);
+	void Clear();
+	void VisibilityChanged(int64_t id);
+};
+
+// Paints the name, properties, filters and visibility buttons of a row. The
+// buttons are styled like the widgets they replace through hidden prototype
+// widgets, so themes apply unchanged.
+class SceneItemDelegate : public QStyledItemDelegate {
+	Q_OBJECT
+
+private:
+	QPushButton *propertiesPrototype;
+	QPushButton *filtersPrototype;
+	VisibilityCheckBox *visibilityPrototype;
+
+	static QRect ButtonRect(const QRect &row, int button);
+
+public:
+	explicit SceneItemDelegate(QWidget *parent);
+
+	void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+	QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+	bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option,
+			 const QModelIndex &index) override;
+};
+
+// The filter hides the rows that do not match instead of rebuilding the list.
+// Typing more of the same filter only checks the rows that are still shown.
+class SceneItemList : public QWidget {
+	Q_OBJECT
+
+private:
+	QLineEdit *filterEdit;
+	QComboBox *filterVisibility;
+	QListView *view;
+	SceneItemModel *model;
+
+	QString filter;
+	int visibility = 0;
+	// Sorted rows that are shown while filtering.
+	std::vector<int> shown;
+
+	bool Filtering() const;
+	bool Matches(int row) const;
+	void FilterRow(int row);
+	void ApplyFilter();
+
+public:
+	explicit SceneItemList(QWidget *parent = nullptr);
+
+	void SetScene(obs_scene_t *scene);
+	void Clear();
+	void VisibilityChanged(int64_t id);
+	std::vector<obs_source_t *> Groups() const;
+};
@@ -0,0 +1,42 @@
+#include "scene-snapshot.hpp"
+
+#include <algorithm>
+
+struct snapshot_context {
+	std::vector<SceneItemEntry> *entries;
+	uint32_t options;
+	int depth;
+};
+
+static bool snapshot_item(obs_scene_t *, obs_sceneitem_t *item, void *param)
+{
+	auto context = static_cast<snapshot_context *>(param);
+	obs_source_t *source = obs_sceneitem_get_source(item);
+	uint32_t flags = 0;
+	if (obs_sceneitem_visible(item))
+		flags |= SCENE_ITEM_VISIBLE;
+	if ((context->options & SCENE_SNAPSHOT_CONFIGURABLE) && obs_source_configurable(source))
+		flags |= SCENE_ITEM_CONFIGURABLE;
+	if (obs_sceneitem_is_group(item)) {
+		flags |= SCENE_ITEM_GROUP;
+		if (context->options & SCENE_SNAPSHOT_GROUPS) {
+			// Members go in before their group, reversing the whole
+			// list afterwards puts them below it.
+			snapshot_context members{context->entries, context->options, context->depth + 1};
+			obs_sceneitem_group_enum_items(item, snapshot_item, &members);
+		}
+	}
+	context->entries->push_back({item, source, obs_sceneitem_get_id(item), context->depth, flags});
+	return true;
+}
+
+void snapshot_scene(obs_scene_t *scene, uint32_t options, std::vector<SceneItemEntry> &entries)
+{
+	entries.clear();
+	if (!scene)
+		return;
+	// Scenes enumerate bottom item first.
+	snapshot_context context{&entries, options, 0};
+	obs_scene_enum_items(scene, snapshot_item, &context);
+	std::reverse(entries.begin(), entries.end());
+}
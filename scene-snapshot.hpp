@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "obs.h"
+
+#define SCENE_ITEM_VISIBLE 0x1
+#define SCENE_ITEM_GROUP 0x2
+#define SCENE_ITEM_CONFIGURABLE 0x4
+
+#define SCENE_SNAPSHOT_GROUPS 0x1
+#define SCENE_SNAPSHOT_CONFIGURABLE 0x2
+
+struct SceneItemEntry {
+	obs_sceneitem_t *item;
+	obs_source_t *source;
+	int64_t id;
+	int depth;
+	uint32_t flags;
+};
+
+// Fills entries with the items of a scene in one enumeration, top item first.
+// With SCENE_SNAPSHOT_GROUPS the members of a group follow their group one
+// level deeper. SCENE_ITEM_CONFIGURABLE is only set with
+// SCENE_SNAPSHOT_CONFIGURABLE. The pointers are owned by the scene, only use
+// them while it is unchanged.
+void snapshot_scene(obs_scene_t *scene, uint32_t options, std::vector<SceneItemEntry> &entries);
@@ -6,12 +6,18 @@
 #include <obs-module.h>
 #include <QCheckBox>
 #include <QCompleter>
+#include <QFile>
+#include <QFileDialog>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QScrollArea>
+#include <QSignalBlocker>
 #include <QTextEdit>
 
 #include "source-dock.hpp"
+#include "mixer-dock.hpp"
+#include "tally-server.hpp"
+#include "flight-recorder.hpp"
 
 #ifndef QT_UTF8
 #define QT_UTF8(str) QString::fromUtf8(str)
@@ -29,6 +35,7 @@ SourceDockSettingsDialog::SourceDockSettingsDialog(QMainWindow *parent)
 	  visibleCheckBox(new QCheckBox()),
 	  previewCheckBox(new QCheckBox()),
 	  volMeterCheckBox(new QCheckBox()),
+	  levelHistoryCheckBox(new QCheckBox()),
 	  volControlsCheckBox(new QCheckBox()),
 	  mediaControlsCheckBox(new QCheckBox()),
 	  switchSceneCheckBox(new QCheckBox()),
@@ -36,7 +43,11 @@ SourceDockSettingsDialog::SourceDockSettingsDialog(QMainWindow *parent)
 	  sceneItemsCheckBox(new QCheckBox()),
 	  propertiesCheckBox(new QCheckBox()),
 	  filtersCheckBox(new QCheckBox()),
-	  textInputCheckBox(new QCheckBox())
+	  textInputCheckBox(new QCheckBox()),
+	  silenceAlarmCheckBox(new QCheckBox()),
+	  spectrumCheckBox(new QCheckBox()),
+	  phaseMeterCheckBox(new QCheckBox()),
+	  trackMetersCheckBox(new QCheckBox())
 {
 	int idx = 0;
 
@@ -59,6 +70,9 @@ SourceDockSettingsDialog::SourceDockSettingsDialog(QMainWindow *parent)
 	label = new VerticalLabel(QT_UTF8(obs_module_text("VolumeMeter")));
 	label->setStyleSheet("font-weight: bold;");
 	mainLayout->addWidget(label, 0, idx++, Qt::AlignCenter);
+	label = new VerticalLabel(QT_UTF8(obs_module_text("LevelHistory")));
+	label->setStyleSheet("font-weight: bold;");
+	mainLayout->addWidget(label, 0, idx++, Qt::AlignCenter);
 	label = new VerticalLabel(QT_UTF8(obs_module_text("AudioControls")));
 	label->setStyleSheet("font-weight: bold;");
 	mainLayout->addWidget(label, 0, idx++, Qt::AlignCenter);
@@ -83,6 +97,18 @@ SourceDockSettingsDialog::SourceDockSettingsDialog(QMainWindow *parent)
 	label = new VerticalLabel(QT_UTF8(obs_module_text("SceneItems")));
 	label->setStyleSheet("font-weight: bold;");
 	mainLayout->addWidget(label, 0, idx++, Qt::AlignCenter);
+	label = new VerticalLabel(QT_UTF8(obs_module_text("SilenceAlarm")));
+	label->setStyleSheet("font-weight: bold;");
+	mainLayout->addWidget(label, 0, idx++, Qt::AlignCenter);
+	label = new VerticalLabel(QT_UTF8(obs_module_text("Spectrum")));
+	label->setStyleSheet("font-weight: bold;");
+	mainLayout->addWidget(label, 0, idx++, Qt::AlignCenter);
+	label = new VerticalLabel(QT_UTF8(obs_module_text("PhaseMeter")));
+	label->setStyleSheet("font-weight: bold;");
+	mainLayout->addWidget(label, 0, idx++, Qt::AlignCenter);
+	label = new VerticalLabel(QT_UTF8(obs_module_text("TrackMeters")));
+	label->setStyleSheet("font-weight: bold;");
+	mainLayout->addWidget(label, 0, idx++, Qt::AlignCenter);
 
 	selectBoxColumn = idx;
 
@@ -124,6 +150,8 @@ SourceDockSettingsDialog::SourceDockSettingsDialog(QMainWindow *parent)
 
 	mainLayout->addWidget(volMeterCheckBox, 1, idx++);
 
+	mainLayout->addWidget(levelHistoryCheckBox, 1, idx++);
+
 	mainLayout->addWidget(volControlsCheckBox, 1, idx++);
 
 	mainLayout->addWidget(mediaControlsCheckBox, 1, idx++);
@@ -140,6 +168,14 @@ SourceDockSettingsDialog::SourceDockSettingsDialog(QMainWindow *parent)
 
 	mainLayout->addWidget(sceneItemsCheckBox, 1, idx++);
 
+	mainLayout->addWidget(silenceAlarmCheckBox, 1, idx++);
+
+	mainLayout->addWidget(spectrumCheckBox, 1, idx++);
+
+	mainLayout->addWidget(phaseMeterCheckBox, 1, idx++);
+
+	mainLayout->addWidget(trackMetersCheckBox, 1, idx++);
+
 	auto addButton = new QPushButton(QT_UTF8(obs_module_text("Add")));
 	connect(addButton, &QPushButton::clicked, [this]() { AddClicked(); });
 	mainLayout->addWidget(addButton, 1, idx++, Qt::AlignCenter);
@@ -163,6 +199,7 @@ SourceDockSettingsDialog::SourceDockSettingsDialog(QMainWindow *parent)
 
 	auto closeButton = new QPushButton(QT_UTF8(obs_module_text("Close")));
 	auto deleteButton = new QPushButton(QT_UTF8(obs_module_text("Delete")));
+	auto addMixerButton = new QPushButton(QT_UTF8(obs_module_text("AddMixer")));
 	auto ltCheckBox = new QCheckBox(QT_UTF8("⌜"));
 	ltCheckBox->setChecked(parent->corner(Qt::TopLeftCorner) == Qt::LeftDockWidgetArea);
 #if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
@@ -206,15 +243,58 @@ SourceDockSettingsDialog::SourceDockSettingsDialog(QMainWindow *parent)
 		main_window->setCorner(Qt::BottomLeftCorner,
 				       lbCheckBox->isChecked() ? Qt::LeftDockWidgetArea : Qt::BottomDockWidgetArea);
 	});
+	auto tallyExportCheckBox = new QCheckBox(QT_UTF8(obs_module_text("TallyExport")));
+	tallyExportCheckBox->setChecked(tally_server != nullptr);
+	tallyExportCheckBox->setToolTip(QT_UTF8(TALLY_SERVER_NAME));
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+	connect(tallyExportCheckBox, &QCheckBox::checkStateChanged, [tallyExportCheckBox]() {
+#else
+	connect(tallyExportCheckBox, &QCheckBox::stateChanged, [tallyExportCheckBox]() {
+#endif
+		set_tally_export(tallyExportCheckBox->isChecked());
+		QSignalBlocker blocker(tallyExportCheckBox);
+		tallyExportCheckBox->setChecked(tally_server != nullptr);
+	});
+	auto flightRecorderCheckBox = new QCheckBox(QT_UTF8(obs_module_text("FlightRecorder")));
+	flightRecorderCheckBox->setChecked(FlightRecorder::IsOpen());
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+	connect(flightRecorderCheckBox, &QCheckBox::checkStateChanged, [flightRecorderCheckBox]() {
+#else
+	connect(flightRecorderCheckBox, &QCheckBox::stateChanged, [flightRecorderCheckBox]() {
+#endif
+		if (flightRecorderCheckBox->isChecked())
+			FlightRecorder::Open(FlightRecorder::DefaultPath());
+		else
+			FlightRecorder::Close();
+		QSignalBlocker blocker(flightRecorderCheckBox);
+		flightRecorderCheckBox->setChecked(FlightRecorder::IsOpen());
+	});
+	auto exportFlightRecorderButton = new QPushButton(QT_UTF8(obs_module_text("ExportFlightRecorder")));
+	connect(exportFlightRecorderButton, &QPushButton::clicked, [this]() {
+		const QString ringPath = FlightRecorder::DefaultPath();
+		if (!QFile::exists(ringPath))
+			return;
+		const QString csvPath = QFileDialog::getSaveFileName(this, QT_UTF8(obs_module_text("ExportFlightRecorder")),
+								     QString(), QStringLiteral("CSV (*.csv)"));
+		if (csvPath.isEmpty())
+			return;
+		if (!FlightRecorder::ExportCsv(ringPath, csvPath))
+			blog(LOG_WARNING, "[Source Dock] failed to export flight recorder to '%s'", QT_TO_UTF8(csvPath));
+	});
 	auto bottomLayout = new QHBoxLayout;
 	bottomLayout->addWidget(deleteButton, 0, Qt::AlignLeft);
+	bottomLayout->addWidget(addMixerButton, 0, Qt::AlignLeft);
 	bottomLayout->addWidget(ltCheckBox, 0, Qt::AlignCenter);
 	bottomLayout->addWidget(rtCheckBox, 0, Qt::AlignCenter);
 	bottomLayout->addWidget(rbCheckBox, 0, Qt::AlignCenter);
 	bottomLayout->addWidget(lbCheckBox, 0, Qt::AlignCenter);
+	bottomLayout->addWidget(tallyExportCheckBox, 0, Qt::AlignCenter);
+	bottomLayout->addWidget(flightRecorderCheckBox, 0, Qt::AlignCenter);
+	bottomLayout->addWidget(exportFlightRecorderButton, 0, Qt::AlignCenter);
 	bottomLayout->addWidget(closeButton, 0, Qt::AlignRight);
 
 	connect(deleteButton, &QPushButton::clicked, [this]() { DeleteClicked(); });
+	connect(addMixerButton, &QPushButton::clicked, [this]() { AddMixerClicked(); });
 	connect(closeButton, &QPushButton::clicked, [this]() { close(); });
 
 	vlayout = new QVBoxLayout;
@@ -293,6 +373,8 @@ void SourceDockSettingsDialog::AddClicked()
 		tmp->EnablePreview();
 	if (volMeterCheckBox->isChecked())
 		tmp->EnableVolMeter();
+	if (levelHistoryCheckBox->isChecked())
+		tmp->EnableLevelHistory();
 	if (volControlsCheckBox->isChecked())
 		tmp->EnableVolControls();
 	if (mediaControlsCheckBox->isChecked())
@@ -309,6 +391,14 @@ void SourceDockSettingsDialog::AddClicked()
 		tmp->EnableTextInput();
 	if (sceneItemsCheckBox->isChecked())
 		tmp->EnableSceneItems();
+	if (silenceAlarmCheckBox->isChecked())
+		tmp->EnableSilenceAlarm();
+	if (spectrumCheckBox->isChecked())
+		tmp->EnableSpectrum();
+	if (phaseMeterCheckBox->isChecked())
+		tmp->EnablePhaseMeter();
+	if (trackMetersCheckBox->isChecked())
+		tmp->EnableTrackMeters();
 
 	auto t = title.toUtf8();
 	if (!obs_frontend_add_dock_by_id(t.constData(), t.constData(), tmp)) {
@@ -336,6 +426,30 @@ void SourceDockSettingsDialog::AddClicked()
 	RefreshTable();
 }
 
+void SourceDockSettingsDialog::AddMixerClicked()
+{
+	auto title = titleEdit->text();
+	if (title.isEmpty())
+		title = QT_UTF8(obs_module_text("SourceMixer"));
+
+	auto window_name = windowEdit->text();
+	QMainWindow *main_window = GetSourceWindowByTitle(window_name);
+	if (main_window == nullptr)
+		main_window = static_cast<QMainWindow *>(obs_frontend_get_main_window());
+
+	auto *tmp = MixerDock::Create(title, main_window);
+	if (!tmp)
+		return;
+	tmp->AddCurrentSceneSources();
+	const auto dock = static_cast<QDockWidget *>(tmp->parentWidget());
+	if (!window_name.isEmpty()) {
+		main_window->addDockWidget(Qt::LeftDockWidgetArea, dock);
+		dock->setFloating(false);
+	}
+	dock->show();
+	RefreshTable();
+}
+
 void SourceDockSettingsDialog::RefreshTable()
 {
 	for (auto row = mainLayout->rowCount() - 1; row >= 2; row--) {
@@ -430,6 +544,23 @@ void SourceDockSettingsDialog::RefreshTable()
 		});
 		mainLayout->addWidget(checkBox, row, col++);
 
+		checkBox = new QCheckBox;
+		checkBox->setChecked(dock->LevelHistoryEnabled());
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+		connect(checkBox, &QCheckBox::checkStateChanged, [checkBox, dock]() {
+#else
+		connect(checkBox, &QCheckBox::stateChanged, [checkBox, dock]() {
+#endif
+			if (checkBox->isChecked()) {
+				dock->EnableLevelHistory();
+				if (!dock->LevelHistoryEnabled())
+					checkBox->setChecked(false);
+			} else {
+				dock->DisableLevelHistory();
+			}
+		});
+		mainLayout->addWidget(checkBox, row, col++);
+
 		checkBox = new QCheckBox;
 		checkBox->setChecked(dock->VolControlsEnabled());
 #if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
@@ -566,10 +697,126 @@ void SourceDockSettingsDialog::RefreshTable()
 		});
 		mainLayout->addWidget(checkBox, row, col++);
 
+		checkBox = new QCheckBox;
+		checkBox->setChecked(dock->SilenceAlarmEnabled());
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+		connect(checkBox, &QCheckBox::checkStateChanged, [checkBox, dock]() {
+#else
+		connect(checkBox, &QCheckBox::stateChanged, [checkBox, dock]() {
+#endif
+			if (checkBox->isChecked()) {
+				dock->EnableSilenceAlarm();
+				if (!dock->SilenceAlarmEnabled())
+					checkBox->setChecked(false);
+			} else {
+				dock->DisableSilenceAlarm();
+			}
+		});
+		mainLayout->addWidget(checkBox, row, col++);
+
+		checkBox = new QCheckBox;
+		checkBox->setChecked(dock->SpectrumEnabled());
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+		connect(checkBox, &QCheckBox::checkStateChanged, [checkBox, dock]() {
+#else
+		connect(checkBox, &QCheckBox::stateChanged, [checkBox, dock]() {
+#endif
+			if (checkBox->isChecked()) {
+				dock->EnableSpectrum();
+				if (!dock->SpectrumEnabled())
+					checkBox->setChecked(false);
+			} else {
+				dock->DisableSpectrum();
+			}
+		});
+		mainLayout->addWidget(checkBox, row, col++);
+
+		checkBox = new QCheckBox;
+		checkBox->setChecked(dock->PhaseMeterEnabled());
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+		connect(checkBox, &QCheckBox::checkStateChanged, [checkBox, dock]() {
+#else
+		connect(checkBox, &QCheckBox::stateChanged, [checkBox, dock]() {
+#endif
+			if (checkBox->isChecked()) {
+				dock->EnablePhaseMeter();
+				if (!dock->PhaseMeterEnabled())
+					checkBox->setChecked(false);
+			} else {
+				dock->DisablePhaseMeter();
+			}
+		});
+		mainLayout->addWidget(checkBox, row, col++);
+
+		checkBox = new QCheckBox;
+		checkBox->setChecked(dock->TrackMetersEnabled());
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+		connect(checkBox, &QCheckBox::checkStateChanged, [checkBox, dock]() {
+#else
+		connect(checkBox, &QCheckBox::stateChanged, [checkBox, dock]() {
+#endif
+			if (checkBox->isChecked()) {
+				dock->EnableTrackMeters();
+				if (!dock->TrackMetersEnabled())
+					checkBox->setChecked(false);
+			} else {
+				dock->DisableTrackMeters();
+			}
+		});
+		mainLayout->addWidget(checkBox, row, col++);
+
 		checkBox = new QCheckBox;
 		mainLayout->addWidget(checkBox, row, col++, Qt::AlignCenter);
 		row++;
 	}
+	if (!sourceName.isEmpty())
+		return;
+	// Mixer docks only have a title, a visible and a select box.
+	for (const auto &it : mixer_docks) {
+		QString t = it->windowTitle();
+		if (!title.isEmpty() && !t.contains(title, Qt::CaseInsensitive))
+			continue;
+		auto parent = dynamic_cast<QMainWindow *>(it->parent()->parent());
+		if (!parent)
+			parent = static_cast<QMainWindow *>(obs_frontend_get_main_window());
+		if (!window.isEmpty()) {
+			auto w = parent->windowTitle();
+			if (!w.contains(window, Qt::CaseInsensitive))
+				continue;
+		}
+		auto col = 0;
+		auto *label = new QLabel(QT_UTF8(obs_module_text("SourceMixer")));
+		label->setProperty("mixer", true);
+		mainLayout->addWidget(label, row, col++);
+
+		label = new QLabel(t);
+		mainLayout->addWidget(label, row, col++);
+
+		label = new QLabel(!parent || parent == obs_frontend_get_main_window() ? "" : parent->windowTitle());
+		mainLayout->addWidget(label, row, col++);
+
+		auto mixer = it;
+		auto *checkBox = new QCheckBox;
+		checkBox->setChecked(!mixer->parentWidget()->isHidden() && !parent->isHidden());
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+		connect(checkBox, &QCheckBox::checkStateChanged, [checkBox, mixer]() {
+#else
+		connect(checkBox, &QCheckBox::stateChanged, [checkBox, mixer]() {
+#endif
+			if (checkBox->isChecked()) {
+				mixer->parentWidget()->show();
+				const auto parent = dynamic_cast<QMainWindow *>(mixer->parent()->parent());
+				parent->show();
+			} else {
+				mixer->parentWidget()->hide();
+			}
+		});
+		mainLayout->addWidget(checkBox, row, col++);
+
+		checkBox = new QCheckBox;
+		mainLayout->addWidget(checkBox, row, selectBoxColumn, Qt::AlignCenter);
+		row++;
+	}
 }
 
 void SourceDockSettingsDialog::mouseDoubleClickEvent(QMouseEvent *event)
@@ -592,7 +839,7 @@ void SourceDockSettingsDialog::mouseDoubleClickEvent(QMouseEvent *event)
 	if (!label)
 		return;
 	const QString sourceName = label->text();
-	if (sourceName.isEmpty())
+	if (sourceName.isEmpty() || label->property("mixer").toBool())
 		return;
 
 	item = mainLayout->itemAtPosition(row, 0);
@@ -624,11 +871,23 @@ void SourceDockSettingsDialog::DeleteClicked()
 		if (!label)
 			continue;
 		std::string sourceName = label->text().toUtf8().constData();
+		const bool mixer = label->property("mixer").toBool();
 		item = mainLayout->itemAtPosition(row, 1);
 		label = dynamic_cast<QLabel *>(item->widget());
 		if (!label)
 			continue;
 		auto title = label->text();
+		if (mixer) {
+			for (auto it = mixer_docks.begin(); it != mixer_docks.end();) {
+				if ((*it)->windowTitle() != title) {
+					++it;
+					continue;
+				}
+				obs_frontend_remove_dock((*it)->objectName().toUtf8().constData());
+				it = mixer_docks.erase(it);
+			}
+			continue;
+		}
 		for (auto it = source_docks.begin(); it != source_docks.end();) {
 			if ((*it)->windowTitle() != title) {
 				++it;
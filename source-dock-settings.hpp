@@ -19,6 +19,7 @@ class SourceDockSettingsDialog : public QDialog {
 	QCheckBox *visibleCheckBox;
 	QCheckBox *previewCheckBox;
 	QCheckBox *volMeterCheckBox;
+	QCheckBox *levelHistoryCheckBox;
 	QCheckBox *volControlsCheckBox;
 	QCheckBox *mediaControlsCheckBox;
 	QCheckBox *switchSceneCheckBox;
@@ -27,6 +28,10 @@ class SourceDockSettingsDialog : public QDialog {
 	QCheckBox *propertiesCheckBox;
 	QCheckBox *filtersCheckBox;
 	QCheckBox *textInputCheckBox;
+	QCheckBox *silenceAlarmCheckBox;
+	QCheckBox *spectrumCheckBox;
+	QCheckBox *phaseMeterCheckBox;
+	QCheckBox *trackMetersCheckBox;
 
 	int selectBoxColumn;
 
@@ -34,6 +39,7 @@ class SourceDockSettingsDialog : public QDialog {
 
 	void AddClicked();
 	void DeleteClicked();
+	void AddMixerClicked();
 	void SelectAllChanged();
 
 public:
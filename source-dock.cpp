@@ -14,11 +14,20 @@
 #include <QFont>
 #include <QFontDialog>
 #include <QColorDialog>
+#include <QSignalBlocker>
+#include <QStyle>
+#include <algorithm>
 
 #include "media-control.hpp"
+#include "mixer-dock.hpp"
 #include "source-dock-settings.hpp"
+#include "sync-offset.hpp"
+#include "tally.hpp"
+#include "tally-server.hpp"
+#include "flight-recorder.hpp"
 #include "version.h"
 #include "graphics/matrix4.h"
+#include "util/platform.h"
 
 #ifndef QT_UTF8
 #define QT_UTF8(str) QString::fromUtf8(str)
@@ -27,14 +36,11 @@
 #define QT_TO_UTF8(str) str.toUtf8().constData()
 #endif
 
-#define ACTIVE_NONE 0
-#define ACTIVE_PREVIEW 1
-#define ACTIVE_PROGRAM 2
-#define ACTIVE_DOWNSTREAM_KEYER 3
-#define ACTIVE_STREAMING 4
-#define ACTIVE_RECORDING 5
-#define ACTIVE_RECORDING_AND_STREAMING 6
-#define ACTIVE_RECORDING_PAUSED 7
+#define PENDING_VOLUME 1
+#define PENDING_MUTE 2
+
+
+#define FADER_GROUPS 8
 
 OBS_DECLARE_MODULE()
 OBS_MODULE_AUTHOR("Exeldro");
@@ -42,6 +48,18 @@ OBS_MODULE_USE_DEFAULT_LOCALE("source-dock", "en-US")
 
 QMainWindow *GetSourceWindowByTitle(const QString window_name);
 
+// Sources are saved by uuid so a dock survives renames, older configs only
+// have the name.
+static obs_source_t *get_saved_source(obs_data_t *data)
+{
+	const char *uuid = obs_data_get_string(data, "source_uuid");
+	if (uuid && *uuid) {
+		if (obs_source_t *source = obs_get_source_by_uuid(uuid))
+			return source;
+	}
+	return obs_get_source_by_name(obs_data_get_string(data, "source_name"));
+}
+
 static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 {
 	const auto main_window = static_cast<QMainWindow *>(obs_frontend_get_main_window());
@@ -52,13 +70,19 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 			obs_data_t *dock = obs_data_create();
 			if (!it->GetSelected()) {
 				obs_data_set_string(dock, "source_name", obs_source_get_name(it->GetSource()));
+				obs_data_set_string(dock, "source_uuid", obs_source_get_uuid(it->GetSource()));
 			}
 			obs_data_set_bool(dock, "selected", it->GetSelected());
 			obs_data_set_string(dock, "title", QT_TO_UTF8(it->windowTitle()));
 			obs_data_set_bool(dock, "hidden", it->parentWidget()->isHidden());
 			obs_data_set_bool(dock, "preview", it->PreviewEnabled());
 			obs_data_set_bool(dock, "volmeter", it->VolMeterEnabled());
+			obs_data_set_bool(dock, "levelhistory", it->LevelHistoryEnabled());
+			obs_data_set_int(dock, "levelhistoryseconds", it->GetLevelHistorySeconds());
 			obs_data_set_bool(dock, "volcontrols", it->VolControlsEnabled());
+			obs_data_set_bool(dock, "volumeramp", it->GetVolumeRamp());
+			obs_data_set_int(dock, "faderlaw", it->GetFaderLaw());
+			obs_data_set_int(dock, "fadergroup", it->GetFaderGroup());
 			obs_data_set_bool(dock, "mediacontrols", it->MediaControlsEnabled());
 			obs_data_set_bool(dock, "showtimedecimals", it->GetShowMs());
 			obs_data_set_bool(dock, "showtimedremaining", it->GetShowTimeRemaining());
@@ -68,6 +92,14 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 			obs_data_set_bool(dock, "properties", it->PropertiesEnabled());
 			obs_data_set_bool(dock, "filters", it->FiltersEnabled());
 			obs_data_set_bool(dock, "textinput", it->TextInputEnabled());
+			obs_data_set_bool(dock, "silencealarm", it->SilenceAlarmEnabled());
+			obs_data_set_double(dock, "silencethreshold", it->GetSilenceThreshold());
+			obs_data_set_int(dock, "silenceduration", it->GetSilenceDuration());
+			obs_data_set_bool(dock, "spectrum", it->SpectrumEnabled());
+			obs_data_set_bool(dock, "phasemeter", it->PhaseMeterEnabled());
+			obs_data_set_bool(dock, "goniometer", it->GetGoniometer());
+			obs_data_set_bool(dock, "trackmeters", it->TrackMetersEnabled());
+			obs_data_set_int(dock, "trackmetertracks", it->GetTrackMeterTracks());
 			auto st = it->GetCustomTextInputStyle();
 			if (st)
 				obs_data_set_obj(dock, "textinputstyle", st);
@@ -93,6 +125,31 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 		}
 		obs_data_set_array(obj, "docks", docks);
 		obs_data_array_release(docks);
+		obs_data_array_t *mixers = obs_data_array_create();
+		for (const auto &it : mixer_docks) {
+			obs_data_t *mixer = obs_data_create();
+			obs_data_set_string(mixer, "title", QT_TO_UTF8(it->windowTitle()));
+			obs_data_set_bool(mixer, "hidden", it->parentWidget()->isHidden());
+			obs_data_set_string(mixer, "geometry", it->parentWidget()->saveGeometry().toBase64().constData());
+			auto *p = dynamic_cast<QMainWindow *>(it->parent()->parent());
+			if (p)
+				obs_data_set_int(mixer, "dockarea", p->dockWidgetArea((QDockWidget *)it->parentWidget()));
+			obs_data_set_bool(mixer, "floating", ((QDockWidget *)it->parentWidget())->isFloating());
+			obs_data_array_t *sources = obs_data_array_create();
+			for (const auto &source : it->GetSources()) {
+				obs_data_t *s = obs_data_create();
+				obs_data_set_string(s, "source_name", obs_source_get_name(source));
+				obs_data_set_string(s, "source_uuid", obs_source_get_uuid(source));
+				obs_data_array_push_back(sources, s);
+				obs_data_release(s);
+			}
+			obs_data_set_array(mixer, "sources", sources);
+			obs_data_array_release(sources);
+			obs_data_array_push_back(mixers, mixer);
+			obs_data_release(mixer);
+		}
+		obs_data_set_array(obj, "mixers", mixers);
+		obs_data_array_release(mixers);
 		obs_data_array_t *windows = obs_data_array_create();
 		for (const auto &it : source_windows) {
 			if (it->isHidden())
@@ -112,6 +169,8 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 		obs_data_set_bool(obj, "corner_tr", main_window->corner(Qt::TopRightCorner) == Qt::RightDockWidgetArea);
 		obs_data_set_bool(obj, "corner_br", main_window->corner(Qt::BottomRightCorner) == Qt::RightDockWidgetArea);
 		obs_data_set_bool(obj, "corner_bl", main_window->corner(Qt::BottomLeftCorner) == Qt::LeftDockWidgetArea);
+		obs_data_set_bool(obj, "tally_export", tally_server != nullptr);
+		obs_data_set_bool(obj, "flight_recorder", FlightRecorder::IsOpen());
 		obs_data_set_obj(save_data, "source-dock", obj);
 
 		obs_data_release(obj);
@@ -121,6 +180,10 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 			it->deleteLater();
 		}
 		source_docks.clear();
+		for (const auto &it : mixer_docks) {
+			obs_frontend_remove_dock(it->objectName().toUtf8().constData());
+		}
+		mixer_docks.clear();
 
 		obs_data_t *obj = obs_data_get_obj(save_data, "source-dock");
 		if (obj) {
@@ -134,6 +197,11 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 			main_window->setCorner(Qt::BottomLeftCorner, obs_data_get_bool(obj, "corner_bl")
 									     ? Qt::LeftDockWidgetArea
 									     : Qt::BottomDockWidgetArea);
+			set_tally_export(obs_data_get_bool(obj, "tally_export"));
+			if (obs_data_get_bool(obj, "flight_recorder"))
+				FlightRecorder::Open(FlightRecorder::DefaultPath());
+			else
+				FlightRecorder::Close();
 			obs_frontend_push_ui_translation(obs_module_get_string);
 			obs_data_array_t *docks = obs_data_get_array(obj, "docks");
 			if (docks) {
@@ -143,7 +211,7 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 					obs_source_t *s = nullptr;
 					QString source_name;
 					if (!obs_data_get_bool(dock, "selected")) {
-						s = obs_get_source_by_name(obs_data_get_string(dock, "source_name"));
+						s = get_saved_source(dock);
 						if (!s) {
 							obs_data_release(dock);
 							continue;
@@ -178,6 +246,12 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 
 					if (obs_data_get_bool(dock, "volmeter"))
 						tmp->EnableVolMeter();
+					tmp->SetLevelHistorySeconds((int)obs_data_get_int(dock, "levelhistoryseconds"));
+					if (obs_data_get_bool(dock, "levelhistory"))
+						tmp->EnableLevelHistory();
+					tmp->SetVolumeRamp(obs_data_get_bool(dock, "volumeramp"));
+					tmp->SetFaderLaw((int)obs_data_get_int(dock, "faderlaw"));
+					tmp->SetFaderGroup((int)obs_data_get_int(dock, "fadergroup"));
 					if (obs_data_get_bool(dock, "volcontrols"))
 						tmp->EnableVolControls();
 					tmp->SetShowMs(obs_data_get_bool(dock, "showtimedecimals"));
@@ -196,6 +270,20 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 						tmp->EnableSceneItems();
 					if (obs_data_get_bool(dock, "textinput"))
 						tmp->EnableTextInput();
+					if (obs_data_has_user_value(dock, "silencethreshold"))
+						tmp->SetSilenceThreshold((float)obs_data_get_double(dock, "silencethreshold"));
+					tmp->SetSilenceDuration((int)obs_data_get_int(dock, "silenceduration"));
+					if (obs_data_get_bool(dock, "silencealarm"))
+						tmp->EnableSilenceAlarm();
+					if (obs_data_get_bool(dock, "spectrum"))
+						tmp->EnableSpectrum();
+					tmp->SetGoniometer(obs_data_get_bool(dock, "goniometer"));
+					if (obs_data_get_bool(dock, "phasemeter"))
+						tmp->EnablePhaseMeter();
+					if (obs_data_has_user_value(dock, "trackmetertracks"))
+						tmp->SetTrackMeterTracks((uint32_t)obs_data_get_int(dock, "trackmetertracks"));
+					if (obs_data_get_bool(dock, "trackmeters"))
+						tmp->EnableTrackMeters();
 					auto st = obs_data_get_obj(dock, "textinputstyle");
 					tmp->SetCustomTextInputStyle(st);
 					obs_data_release(st);
@@ -235,6 +323,45 @@ static void frontend_save_load(obs_data_t *save_data, bool saving, void *)
 				}
 				obs_data_array_release(docks);
 			}
+			obs_data_array_t *mixers = obs_data_get_array(obj, "mixers");
+			if (mixers) {
+				size_t count = obs_data_array_count(mixers);
+				for (size_t i = 0; i < count; i++) {
+					obs_data_t *mixer = obs_data_array_item(mixers, i);
+					auto tmp = MixerDock::Create(QT_UTF8(obs_data_get_string(mixer, "title")), main_window);
+					if (!tmp) {
+						obs_data_release(mixer);
+						continue;
+					}
+					obs_data_array_t *sources = obs_data_get_array(mixer, "sources");
+					size_t source_count = obs_data_array_count(sources);
+					for (size_t j = 0; j < source_count; j++) {
+						obs_data_t *s = obs_data_array_item(sources, j);
+						obs_source_t *source = get_saved_source(s);
+						tmp->AddSource(source);
+						obs_source_release(source);
+						obs_data_release(s);
+					}
+					obs_data_array_release(sources);
+
+					const auto d = static_cast<QDockWidget *>(tmp->parentWidget());
+					if (obs_data_get_bool(mixer, "hidden"))
+						d->hide();
+					else
+						d->show();
+					const auto dockarea = static_cast<Qt::DockWidgetArea>(obs_data_get_int(mixer, "dockarea"));
+					if (dockarea != main_window->dockWidgetArea(d))
+						main_window->addDockWidget(dockarea, d);
+					const auto floating = obs_data_get_bool(mixer, "floating");
+					if (d->isFloating() != floating)
+						d->setFloating(floating);
+					const char *geometry = obs_data_get_string(mixer, "geometry");
+					if (geometry && strlen(geometry))
+						d->restoreGeometry(QByteArray::fromBase64(QByteArray(geometry)));
+					obs_data_release(mixer);
+				}
+				obs_data_array_release(mixers);
+			}
 			obs_data_array_t *windows = obs_data_get_array(obj, "windows");
 			if (windows) {
 				size_t count = obs_data_array_count(windows);
@@ -311,120 +438,80 @@ void set_previous_scene_empty(void *p, calldata_t *calldata)
 	previous_scene = nullptr;
 }
 
+static void request_update_active();
+
+static TallyEngine tally_engine(request_update_active);
+
+// Runs on the UI thread, it reads source_docks and updates the dock widgets
+// directly. The tally engine only enumerates scenes that changed.
 void update_active(void *param)
 {
 	UNUSED_PARAMETER(param);
-	std::map<obs_source_t *, int> source_active;
+	static std::vector<obs_source_t *> sources;
+	static std::vector<int> states;
+	static std::vector<SourceDock *> docks;
+	sources.clear();
+	docks.clear();
 	for (const auto &it : source_docks) {
-		if (it->ShowActiveEnabled())
-			source_active[it->GetSource()] = ACTIVE_NONE;
+		if (!tally_server && !it->ShowActiveEnabled())
+			continue;
+		sources.push_back(it->GetSource());
+		docks.push_back(it);
 	}
-	if (source_active.empty())
+	if (sources.empty()) {
+		tally_engine.Clear();
+		if (tally_server)
+			tally_server->Publish(sources, states);
 		return;
-	auto *preview = obs_frontend_get_current_preview_scene();
-	if (preview) {
-		for (auto &i : source_active) {
-			if (i.first == preview) {
-				i.second = ACTIVE_PREVIEW;
-				break;
-			}
-		}
-		obs_source_enum_active_tree(
-			preview,
-			[](obs_source_t *parent, obs_source_t *child, void *param) {
-				UNUSED_PARAMETER(parent);
-				auto m = static_cast<std::map<obs_source_t *, int> *>(param);
+	}
+	tally_engine.Update();
+	tally_engine.Resolve(sources, states);
+	for (size_t i = 0; i < docks.size(); i++)
+		docks[i]->SetActive(states[i]);
+	if (tally_server)
+		tally_server->Publish(sources, states);
+}
 
-				for (auto &i : *m) {
+// Activation signals and frontend events only mark the tally state dirty, the
+// first one queues a single recomputation for all docks.
+static std::atomic<bool> active_dirty{false};
+static std::atomic<uint64_t> active_requests{0};
+static std::atomic<uint64_t> active_updates{0};
+// Totals of the logged dock counts, only used on the UI thread.
+static uint64_t scene_item_signals = 0;
+static uint64_t scene_item_refreshes = 0;
 
-					if (i.first == child) {
-						i.second = ACTIVE_PREVIEW;
-						break;
-					}
-				}
-			},
-			&source_active);
-		obs_source_release(preview);
-	}
-	for (uint32_t channel = 1; channel < MAX_CHANNELS; channel++) {
-		auto dsk = obs_get_output_source(channel);
-		if (!dsk)
-			continue;
-		const char *scene_name = obs_source_get_name(dsk);
-		for (auto &i : source_active) {
-			auto *sn = obs_source_get_name(i.first);
-			if (strcmp(sn, scene_name) == 0) {
-				i.second = ACTIVE_DOWNSTREAM_KEYER;
-				break;
-			}
-		}
-		obs_source_enum_active_tree(
-			dsk,
-			[](obs_source_t *parent, obs_source_t *child, void *param) {
-				UNUSED_PARAMETER(parent);
-				auto m = static_cast<std::map<obs_source_t *, int> *>(param);
-				const char *child_name = obs_source_get_name(child);
-				if (!child_name || strlen(child_name) == 0)
-					return;
-				for (auto &i : *m) {
-					auto *sn = obs_source_get_name(i.first);
-					if (strcmp(sn, child_name) == 0) {
-						i.second = ACTIVE_DOWNSTREAM_KEYER;
-						break;
-					}
-				}
-			},
-			&source_active);
-
-		obs_source_release(dsk);
-	}
-	if (auto *program = obs_frontend_get_current_scene()) {
-		const char *scene_name = obs_source_get_name(program);
-		for (auto &i : source_active) {
-			auto *sn = obs_source_get_name(i.first);
-			if (strcmp(sn, scene_name) == 0) {
-				i.second = ACTIVE_PROGRAM;
-				break;
-			}
-		}
-		obs_source_enum_active_tree(
-			program,
-			[](obs_source_t *parent, obs_source_t *child, void *param) {
-				UNUSED_PARAMETER(parent);
-				auto m = static_cast<std::map<obs_source_t *, int> *>(param);
-				const char *child_name = obs_source_get_name(child);
-				if (!child_name || strlen(child_name) == 0)
-					return;
-				for (auto &i : *m) {
-					auto *sn = obs_source_get_name(i.first);
-					if (strcmp(sn, child_name) == 0) {
-						i.second = ACTIVE_PROGRAM;
-						break;
-					}
-				}
-			},
-			&source_active);
-		obs_source_release(program);
-	}
-	for (const auto &it : source_docks) {
-		int active = source_active[it->GetSource().Get()];
-		if (active == ACTIVE_PROGRAM) {
-			if (obs_frontend_streaming_active()) {
-				if (obs_frontend_recording_active() && !obs_frontend_recording_paused()) {
-					active = ACTIVE_RECORDING_AND_STREAMING;
-				} else {
-					active = ACTIVE_STREAMING;
-				}
-			} else if (obs_frontend_recording_active()) {
-				if (obs_frontend_recording_paused()) {
-					active = ACTIVE_RECORDING_PAUSED;
-				} else {
-					active = ACTIVE_RECORDING;
-				}
-			}
+static void update_active_task(void *param)
+{
+	UNUSED_PARAMETER(param);
+	active_dirty = false;
+	active_updates++;
+	update_active(nullptr);
+}
+
+static void request_update_active()
+{
+	active_requests++;
+	if (active_dirty.exchange(true))
+		return;
+	obs_queue_task(OBS_TASK_UI, update_active_task, nullptr, false);
+}
+
+void set_tally_export(bool enable)
+{
+	if (enable == (tally_server != nullptr))
+		return;
+	if (enable) {
+		tally_server = new TallyServer;
+		if (!tally_server->Listen()) {
+			delete tally_server;
+			tally_server = nullptr;
+			return;
 		}
-		QMetaObject::invokeMethod(it, "SetActive", Qt::QueuedConnection, Q_ARG(int, active));
-		//it->SetActive(source_active[it->GetSource().Get()]);
+		request_update_active();
+	} else {
+		delete tally_server;
+		tally_server = nullptr;
 	}
 }
 
@@ -436,6 +523,11 @@ static void frontend_event(enum obs_frontend_event event, void *)
 			obs_frontend_remove_dock(it->objectName().toUtf8().constData());
 		}
 		source_docks.clear();
+		tally_engine.Clear();
+		for (const auto &it : mixer_docks) {
+			obs_frontend_remove_dock(it->objectName().toUtf8().constData());
+		}
+		mixer_docks.clear();
 		for (const auto &it : source_windows) {
 			it->close();
 			delete (it);
@@ -471,18 +563,31 @@ static void frontend_event(enum obs_frontend_event event, void *)
 		}
 		update_selected_source();
 
-		obs_queue_task(obs_in_task_thread(OBS_TASK_GRAPHICS) ? OBS_TASK_UI : OBS_TASK_GRAPHICS, update_active, nullptr,
-			       false);
+		request_update_active();
 	} else if (event == OBS_FRONTEND_EVENT_STREAMING_STARTING || event == OBS_FRONTEND_EVENT_STREAMING_STARTED ||
 		   event == OBS_FRONTEND_EVENT_STREAMING_STOPPING || event == OBS_FRONTEND_EVENT_STREAMING_STOPPED ||
 		   event == OBS_FRONTEND_EVENT_RECORDING_STARTING || event == OBS_FRONTEND_EVENT_RECORDING_STARTED ||
 		   event == OBS_FRONTEND_EVENT_RECORDING_STOPPING || event == OBS_FRONTEND_EVENT_RECORDING_STOPPED ||
 		   event == OBS_FRONTEND_EVENT_RECORDING_PAUSED || event == OBS_FRONTEND_EVENT_RECORDING_UNPAUSED) {
-		obs_queue_task(obs_in_task_thread(OBS_TASK_GRAPHICS) ? OBS_TASK_UI : OBS_TASK_GRAPHICS, update_active, nullptr,
-			       false);
+		request_update_active();
 	}
 }
 
+// Downstream keyer changes can change the tally of any dock.
+static void source_changed(void *data, calldata_t *call_data)
+{
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(call_data);
+	request_update_active();
+}
+
+// Private duplicates are matched by name, a rename can change their tally.
+static void source_rename(void *data, calldata_t *call_data)
+{
+	UNUSED_PARAMETER(data);
+	tally_engine.Renamed(static_cast<obs_source_t *>(calldata_ptr(call_data, "source")));
+}
+
 static void source_remove(void *data, calldata_t *call_data)
 {
 	UNUSED_PARAMETER(data);
@@ -495,6 +600,8 @@ static void source_remove(void *data, calldata_t *call_data)
 			++it;
 		}
 	}
+	for (const auto &it : mixer_docks)
+		it->RemoveSource(source);
 }
 
 bool obs_module_load()
@@ -504,6 +611,8 @@ bool obs_module_load()
 	obs_frontend_add_save_callback(frontend_save_load, nullptr);
 	obs_frontend_add_event_callback(frontend_event, nullptr);
 	signal_handler_connect(obs_get_signal_handler(), "source_remove", source_remove, nullptr);
+	signal_handler_connect(obs_get_signal_handler(), "source_rename", source_rename, nullptr);
+	signal_handler_connect(obs_get_signal_handler(), "channel_change", source_changed, nullptr);
 
 	const auto action = static_cast<QAction *>(obs_frontend_add_tools_menu_qaction(obs_module_text("SourceDock")));
 
@@ -525,6 +634,21 @@ void obs_module_unload()
 	obs_frontend_remove_save_callback(frontend_save_load, nullptr);
 	obs_frontend_remove_event_callback(frontend_event, nullptr);
 	signal_handler_disconnect(obs_get_signal_handler(), "source_remove", source_remove, nullptr);
+	signal_handler_disconnect(obs_get_signal_handler(), "source_rename", source_rename, nullptr);
+	signal_handler_disconnect(obs_get_signal_handler(), "channel_change", source_changed, nullptr);
+	set_tally_export(false);
+	FlightRecorder::Close();
+	const uint64_t requests = active_requests;
+	const uint64_t updates = active_updates;
+	if (requests)
+		blog(LOG_INFO, "[Source Dock] %llu active state changes handled with %llu recomputations, %llu saved",
+		     (unsigned long long)requests, (unsigned long long)updates, (unsigned long long)(requests - updates));
+	for (const auto &it : source_docks)
+		it->LogSceneItemSignalCounts();
+	if (scene_item_signals)
+		blog(LOG_INFO, "[Source Dock] %llu scene item signals handled with %llu refreshes, %llu saved",
+		     (unsigned long long)scene_item_signals, (unsigned long long)scene_item_refreshes,
+		     (unsigned long long)(scene_item_signals - scene_item_refreshes));
 }
 
 MODULE_EXPORT const char *obs_module_description(void)
@@ -537,13 +661,6 @@ MODULE_EXPORT const char *obs_module_name(void)
 	return obs_module_text("SourceDock");
 }
 
-#define LOG_OFFSET_DB 6.0f
-#define LOG_RANGE_DB 96.0f
-/* equals -log10f(LOG_OFFSET_DB) */
-#define LOG_OFFSET_VAL -0.77815125038364363f
-/* equals -log10f(-LOG_RANGE_DB + LOG_OFFSET_DB) */
-#define LOG_RANGE_VAL -2.00860017176191756f
-
 SourceDock::SourceDock(QString name, bool selected_, QWidget *parent)
 	: QSplitter(parent),
 	  eventFilter(BuildEventFilter()),
@@ -559,10 +676,15 @@ SourceDock::SourceDock(QString name, bool selected_, QWidget *parent)
 
 SourceDock::~SourceDock()
 {
+	DisableTrackMeters();
+	DisablePhaseMeter();
+	DisableSpectrum();
+	DisableSilenceAlarm();
 	DisableFilters();
 	DisableProperties();
 	DisableSceneItems();
 	DisableShowActive();
+	DisableLevelHistory();
 	DisableVolMeter();
 	DisableVolControls();
 	DisableMediaControls();
@@ -635,8 +757,19 @@ void SourceDock::OBSVolumeLevel(void *data, const float magnitude[MAX_AUDIO_CHAN
 				const float inputPeak[MAX_AUDIO_CHANNELS])
 {
 	SourceDock *sourceDock = static_cast<SourceDock *>(data);
+	if (FlightRecorder::IsOpen() && ++sourceDock->levelRecordCounter >= FLIGHT_RECORDER_LEVEL_INTERVAL) {
+		sourceDock->levelRecordCounter = 0;
+		float maxPeak = -INFINITY;
+		for (int i = 0; i < MAX_AUDIO_CHANNELS; i++)
+			maxPeak = std::max(maxPeak, peak[i]);
+		FlightRecorder::Record(FLIGHT_RECORD_LEVEL, obs_source_get_name(sourceDock->source), maxPeak);
+	}
 	if (sourceDock->volMeter)
 		sourceDock->volMeter->setLevels(magnitude, peak, inputPeak);
+	if (sourceDock->levelHistory)
+		sourceDock->levelHistory->setLevels(magnitude, peak);
+	if (sourceDock->silenceAlarm.load(std::memory_order_relaxed))
+		sourceDock->SilenceLevel(peak);
 }
 
 void SourceDock::OBSVolume(void *data, calldata_t *call_data)
@@ -645,8 +778,11 @@ void SourceDock::OBSVolume(void *data, calldata_t *call_data)
 	calldata_get_ptr(call_data, "source", &source);
 	double volume;
 	calldata_get_float(call_data, "volume", &volume);
+	if (FlightRecorder::IsOpen())
+		FlightRecorder::Record(FLIGHT_RECORD_VOLUME, obs_source_get_name(source), volume);
 	SourceDock *sourceDock = static_cast<SourceDock *>(data);
-	QMetaObject::invokeMethod(sourceDock, "SetOutputVolume", Qt::QueuedConnection, Q_ARG(double, volume));
+	sourceDock->pendingVolume = (float)volume;
+	sourceDock->QueueVolumeUpdate(PENDING_VOLUME);
 }
 
 void SourceDock::OBSMute(void *data, calldata_t *call_data)
@@ -654,15 +790,52 @@ void SourceDock::OBSMute(void *data, calldata_t *call_data)
 	obs_source_t *source;
 	calldata_get_ptr(call_data, "source", &source);
 	bool muted = calldata_bool(call_data, "muted");
+	if (FlightRecorder::IsOpen())
+		FlightRecorder::Record(FLIGHT_RECORD_MUTE, obs_source_get_name(source), muted ? 1.0 : 0.0);
 	SourceDock *sourceDock = static_cast<SourceDock *>(data);
-	QMetaObject::invokeMethod(sourceDock, "SetMute", Qt::QueuedConnection, Q_ARG(bool, muted));
+	sourceDock->pendingMute = muted;
+	sourceDock->QueueVolumeUpdate(PENDING_MUTE);
+}
+
+void SourceDock::QueueVolumeUpdate(int update)
+{
+	volumeSignalCount++;
+	// Only post an event when none is pending, otherwise the pending one
+	// picks up the latest value.
+	if (pendingVolumeUpdates.fetch_or(update) != 0) {
+		volumeSignalCoalesced++;
+		return;
+	}
+	QMetaObject::invokeMethod(this, [this]() { ApplyPendingVolumeUpdates(); }, Qt::QueuedConnection);
+}
+
+void SourceDock::ApplyPendingVolumeUpdates()
+{
+	const int updates = pendingVolumeUpdates.exchange(0);
+	if (!volControl)
+		return;
+	if (updates & PENDING_VOLUME)
+		SetOutputVolume(pendingVolume.load());
+	if (updates & PENDING_MUTE)
+		SetMute(pendingMute.load());
+}
+
+void SourceDock::LogVolumeSignalCounts()
+{
+	const uint64_t count = volumeSignalCount.exchange(0);
+	const uint64_t coalesced = volumeSignalCoalesced.exchange(0);
+	if (count || volumeSetCount)
+		blog(LOG_INFO, "[Source Dock] '%s' received %llu volume/mute signals, %llu coalesced, sent %llu volume changes",
+		     QT_TO_UTF8(windowTitle()), (unsigned long long)count, (unsigned long long)coalesced,
+		     (unsigned long long)volumeSetCount);
+	volumeSetCount = 0;
 }
 
 void SourceDock::OBSActiveChanged(void *data, calldata_t *call_data)
 {
 	UNUSED_PARAMETER(call_data);
-	SourceDock *sourceDock = static_cast<SourceDock *>(data);
-	QMetaObject::invokeMethod(sourceDock, "ActiveChanged", Qt::QueuedConnection);
+	UNUSED_PARAMETER(data);
+	request_update_active();
 }
 
 void SourceDock::LockVolumeControl(bool lock)
@@ -673,23 +846,42 @@ void SourceDock::LockVolumeControl(bool lock)
 
 void SourceDock::MuteVolumeControl(bool mute)
 {
-	if (source && obs_source_muted(source) != mute)
-		obs_source_set_muted(source, mute);
+	if (!source || obs_source_muted(source) == mute)
+		return;
+	obs_source_set_muted(source, mute);
+	if (!faderGroup)
+		return;
+	for (auto it : source_docks) {
+		if (it != this && it->faderGroup == faderGroup && it->source && obs_source_muted(it->source) != mute)
+			obs_source_set_muted(it->source, mute);
+	}
 }
 
 void SourceDock::SetOutputVolume(double volume)
 {
+	// Ignore the echo of our own changes and anything that arrives while the
+	// user is still moving the slider.
+	if (volumeSender.Ignore((float)volume, slider->isSliderDown()))
+		return;
 	float db = obs_mul_to_db(volume);
-	float def;
-	if (db >= 0.0f)
-		def = 1.0f;
-	else if (db <= -96.0f)
-		def = 0.0f;
-	else
-		def = (-log10f(-db + LOG_OFFSET_DB) - LOG_RANGE_VAL) / (LOG_OFFSET_VAL - LOG_RANGE_VAL);
-
-	int val = def * 10000.0;
+	int val = fader_db_to_def(faderLaw, db) * 10000.0;
+	const QSignalBlocker blocker(slider);
 	slider->setValue(val);
+	UpdateVolumeToolTip(db);
+}
+
+void SourceDock::UpdateVolumeToolTip(float db)
+{
+	const QString level = db > -INFINITY ? QString::number(db, 'f', 1) : QStringLiteral("-inf");
+	slider->setToolTip(QString::fromUtf8(obs_module_text("VolumeOutputDb")).arg(level));
+}
+
+void SourceDock::SetFaderLaw(int law)
+{
+	if (law < 0 || law >= FADER_LAW_COUNT)
+		law = FADER_LAW_LOG;
+	faderLaw = law;
+	UpdateVolControls();
 }
 
 void SourceDock::SetMute(bool muted)
@@ -699,180 +891,129 @@ void SourceDock::SetMute(bool muted)
 
 void SourceDock::ActiveChanged()
 {
-	int active = ACTIVE_NONE;
-
-	if (auto *preview = obs_frontend_get_current_preview_scene()) {
-		if (source == preview) {
-			active = ACTIVE_PREVIEW;
-		}
-		std::pair<obs_source_t *, int> t = std::pair<obs_source_t *, int>(source, active);
-		obs_source_enum_active_tree(
-			preview,
-			[](obs_source_t *parent, obs_source_t *child, void *param) {
-				UNUSED_PARAMETER(parent);
-				auto m = (std::pair<obs_source_t *, int> *)param;
-				if (m->first == child) {
-					m->second = ACTIVE_PREVIEW;
-				}
-			},
-			&t);
-		active = t.second;
-		obs_source_release(preview);
-	}
-	for (uint32_t channel = 1; channel < MAX_CHANNELS; channel++) {
-		auto dsk = obs_get_output_source(channel);
-		if (!dsk)
-			continue;
-		const char *scene_name = obs_source_get_name(dsk);
+	request_update_active();
+}
 
-		auto *sn = obs_source_get_name(source);
-		if (strcmp(sn, scene_name) == 0) {
-			active = ACTIVE_DOWNSTREAM_KEYER;
-		}
-		std::pair<obs_source_t *, int> t = std::pair<obs_source_t *, int>(source, active);
-		obs_source_enum_active_tree(
-			dsk,
-			[](obs_source_t *parent, obs_source_t *child, void *param) {
-				UNUSED_PARAMETER(parent);
-				auto m = (std::pair<obs_source_t *, int> *)param;
-				const char *child_name = obs_source_get_name(child);
-				if (!child_name || strlen(child_name) == 0)
-					return;
-
-				auto *sn = obs_source_get_name(m->first);
-				if (strcmp(sn, child_name) == 0) {
-					m->second = ACTIVE_DOWNSTREAM_KEYER;
-				}
-			},
-			&t);
-		active = t.second;
+// Everything SetActive shows for a tally state, built once. Program has a
+// second entry for studio mode, where program is shown in red.
+struct TallyStyle {
+	QString frameStyle;
+	const char *themeID;
+	const char *className;
+	QString text;
+};
 
-		obs_source_release(dsk);
-	}
-	if (auto *program = obs_frontend_get_current_scene()) {
-		const char *scene_name = obs_source_get_name(program);
-		auto *sn = obs_source_get_name(source);
-		if (strcmp(sn, scene_name) == 0) {
-			active = ACTIVE_PROGRAM;
-		}
-		std::pair<obs_source_t *, int> t = std::pair<obs_source_t *, int>(source, active);
-		obs_source_enum_active_tree(
-			program,
-			[](obs_source_t *parent, obs_source_t *child, void *param) {
-				UNUSED_PARAMETER(parent);
-				auto m = (std::pair<obs_source_t *, int> *)param;
-				const char *child_name = obs_source_get_name(child);
-				if (!child_name || strlen(child_name) == 0)
-					return;
-
-				auto *sn = obs_source_get_name(m->first);
-				if (strcmp(sn, child_name) == 0) {
-					m->second = ACTIVE_PROGRAM;
-				}
-			},
-			&t);
-		active = t.second;
-		obs_source_release(program);
-	}
-	if (active == ACTIVE_PROGRAM) {
-		if (obs_frontend_streaming_active()) {
-			if (obs_frontend_recording_active() && !obs_frontend_recording_paused()) {
-				active = ACTIVE_RECORDING_AND_STREAMING;
-			} else {
-				active = ACTIVE_STREAMING;
-			}
-		} else if (obs_frontend_recording_active()) {
-			if (obs_frontend_recording_paused()) {
-				active = ACTIVE_RECORDING_PAUSED;
-			} else {
-				active = ACTIVE_RECORDING;
-			}
-		}
-	}
-	SetActive(active);
+#define TALLY_STYLE_PROGRAM_STUDIO (ACTIVE_RECORDING_PAUSED + 1)
+#define TALLY_STYLE_COUNT (TALLY_STYLE_PROGRAM_STUDIO + 1)
+
+static const TallyStyle &get_tally_style(int style)
+{
+	static const TallyStyle styles[TALLY_STYLE_COUNT] = {
+		{"", "", "", QT_UTF8(obs_module_text("NotActive"))},
+		{"QFrame{background-color: #00FF00;}", "good", "text-success", QT_UTF8(obs_module_text("Preview"))}, // green
+		{"QFrame{background-color: #00FF00;}", "good", "text-success", QT_UTF8(obs_module_text("Active"))}, // green
+		{"QFrame{background-color: #FFA500;}", "warning", "text-warning",
+		 QT_UTF8(obs_module_text("DownstreamKeyer"))}, // orange
+		{"QFrame{background-color: #00FFFF;}", "error", "text-danger", QT_UTF8(obs_module_text("Streaming"))}, // cyan
+		{"QFrame{background-color: #FF0000;}", "error", "text-danger", QT_UTF8(obs_module_text("Recording"))}, // red
+		{"QFrame{background-color: #FF00FF;}", "error", "text-danger",
+		 QT_UTF8(obs_module_text("StreamingAndRecording"))}, // magenta
+		{"QFrame{background-color: #FFFF00;}", "warning", "text-warning",
+		 QT_UTF8(obs_module_text("RecordingPaused"))}, // yellow
+		{"QFrame{background-color: #FFA500;}", "error", "text-danger", QT_UTF8(obs_module_text("Active"))}, // orange
+	};
+	return styles[style];
 }
 
 void SourceDock::SetActive(int active)
 {
-	if (activeFrame) {
-		if (active == ACTIVE_STREAMING) {
-			activeFrame->setStyleSheet("QFrame{background-color: #00FFFF;}"); // cyan
-		} else if (active == ACTIVE_RECORDING_AND_STREAMING) {
-			activeFrame->setStyleSheet("QFrame{background-color: #FF00FF;}"); // magenta
-		} else if (active == ACTIVE_RECORDING) {
-			activeFrame->setStyleSheet("QFrame{background-color: #FF0000;}"); // red
-		} else if (active == ACTIVE_RECORDING_PAUSED) {
-			activeFrame->setStyleSheet("QFrame{background-color: #FFFF00;}"); // yellow
-		} else if (active == ACTIVE_PROGRAM) {
-			if (obs_frontend_preview_program_mode_active()) {
-				activeFrame->setStyleSheet("QFrame{background-color: #FFA500;}"); // orange
-			} else {
-				activeFrame->setStyleSheet("QFrame{background-color: #00FF00;}"); // green
-			}
-		} else if (active == ACTIVE_PREVIEW) {
-			activeFrame->setStyleSheet("QFrame{background-color: #00FF00;}"); // green
-		} else if (active == ACTIVE_DOWNSTREAM_KEYER) {
-			activeFrame->setStyleSheet("QFrame{background-color: #FFA500;}"); // orange
-		} else {
-			activeFrame->setStyleSheet("");
-		}
+	if (active != recordedActive) {
+		recordedActive = active;
+		if (FlightRecorder::IsOpen())
+			FlightRecorder::Record(FLIGHT_RECORD_TALLY, obs_source_get_name(source), active);
 	}
-	if (activeLabel) {
-		if (active == ACTIVE_STREAMING) {
-			activeLabel->setProperty("themeID", "error");
-			activeLabel->setProperty("class", "text-danger");
-			activeLabel->setText(QT_UTF8(obs_module_text("Streaming")));
-		} else if (active == ACTIVE_RECORDING) {
-			activeLabel->setProperty("themeID", "error");
-			activeLabel->setProperty("class", "text-danger");
-			activeLabel->setText(QT_UTF8(obs_module_text("Recording")));
-		} else if (active == ACTIVE_RECORDING_AND_STREAMING) {
-			activeLabel->setProperty("themeID", "error");
-			activeLabel->setProperty("class", "text-danger");
-			activeLabel->setText(QT_UTF8(obs_module_text("StreamingAndRecording")));
-		} else if (active == ACTIVE_RECORDING_PAUSED) {
-			activeLabel->setProperty("themeID", "warning");
-			activeLabel->setProperty("class", "text-warning");
-			activeLabel->setText(QT_UTF8(obs_module_text("RecordingPaused")));
-		} else if (active == ACTIVE_PROGRAM) {
-			activeLabel->setProperty("themeID", obs_frontend_preview_program_mode_active() ? "error" : "good");
-			activeLabel->setProperty("class",
-						 obs_frontend_preview_program_mode_active() ? "text-danger" : "text-success");
-			activeLabel->setText(QT_UTF8(obs_module_text("Active")));
-		} else if (active == ACTIVE_PREVIEW) {
-			activeLabel->setProperty("themeID", "good");
-			activeLabel->setProperty("class", "text-success");
-			activeLabel->setText(QT_UTF8(obs_module_text("Preview")));
-		} else if (active == ACTIVE_DOWNSTREAM_KEYER) {
-			activeLabel->setProperty("themeID", "warning");
-			activeLabel->setProperty("class", "text-warning");
-			activeLabel->setText(QT_UTF8(obs_module_text("DownstreamKeyer")));
-		} else {
-			activeLabel->setText(QT_UTF8(obs_module_text("NotActive")));
-			activeLabel->setProperty("themeID", "");
-			activeLabel->setProperty("class", "");
-		}
 
-		/* force style sheet recalculation */
-		QString qss = activeLabel->styleSheet();
-		activeLabel->setStyleSheet("/* */");
-		activeLabel->setStyleSheet(qss);
+	int style = active;
+	if (style < ACTIVE_NONE || style > ACTIVE_RECORDING_PAUSED)
+		style = ACTIVE_NONE;
+	else if (style == ACTIVE_PROGRAM && obs_frontend_preview_program_mode_active())
+		style = TALLY_STYLE_PROGRAM_STUDIO;
+
+	// Only touch the widgets when what they show changes, style sheet
+	// recalculation is expensive and this runs for every dock on every event.
+	if (activeFrame && activeFrameStyle != style) {
+		activeFrameStyle = style;
+		activeFrame->setStyleSheet(get_tally_style(style).frameStyle);
+	}
+	if (activeLabel && activeLabelStyle != style) {
+		activeLabelStyle = style;
+		const TallyStyle &tallyStyle = get_tally_style(style);
+		activeLabel->setProperty("themeID", tallyStyle.themeID);
+		activeLabel->setProperty("class", tallyStyle.className);
+		activeLabel->setText(tallyStyle.text);
+
+		/* force style recalculation for the changed properties */
+		activeLabel->style()->unpolish(activeLabel);
+		activeLabel->style()->polish(activeLabel);
 	}
 }
 
 void SourceDock::SliderChanged(int vol)
 {
-	float def = (float)vol / 10000.0f;
-	float db;
-	if (def >= 1.0f)
-		db = 0.0f;
-	else if (def <= 0.0f)
-		db = -INFINITY;
-	else
-		db = -(LOG_RANGE_DB + LOG_OFFSET_DB) * powf((LOG_RANGE_DB + LOG_OFFSET_DB) / LOG_OFFSET_DB, -def) + LOG_OFFSET_DB;
-	const float mul = obs_db_to_mul(db);
-	if (source)
-		obs_source_set_volume(source, mul);
+	const float db = fader_def_to_db(faderLaw, (float)vol / 10000.0f);
+	UpdateVolumeToolTip(db);
+	if (!source || !volumeSender.SliderChanged(obs_db_to_mul(db)))
+		return;
+	// Send the first change right away, the timer sends the rest once per audio tick.
+	SendVolume();
+	if (volumeSender.Ticking())
+		volumeTimer->start();
+}
+
+void SourceDock::SendVolume()
+{
+	float mul;
+	if (!source || !volumeSender.Tick(volumeRamp, mul)) {
+		volumeTimer->stop();
+		return;
+	}
+	const float previousDb = obs_mul_to_db(obs_source_get_volume(source));
+	volumeSetCount++;
+	obs_source_set_volume(source, mul);
+	if (faderGroup)
+		ApplyGroupVolume(obs_mul_to_db(mul) - previousDb);
+}
+
+void SourceDock::ApplyGroupVolume(float deltaDb)
+{
+	if (!std::isfinite(deltaDb) || deltaDb == 0.0f)
+		return;
+	// Move every other member by the same amount in one pass. Their sliders are
+	// updated here directly and the volume signals that come back are ignored
+	// as echoes.
+	for (auto it : source_docks) {
+		if (it == this || it->faderGroup != faderGroup || !it->source || it->source == source)
+			continue;
+		const float db = obs_mul_to_db(obs_source_get_volume(it->source));
+		if (!std::isfinite(db))
+			continue;
+		// Keep members within what their slider shows, but never pull one that
+		// is already outside that range further in or out than the move asks.
+		const float maximumDb = std::max(db, fader_def_to_db(it->faderLaw, 1.0f));
+		const float minimumDb = std::min(db, VOLUME_MINIMUM_DB);
+		const float newDb = std::clamp(db + deltaDb, minimumDb, maximumDb);
+		if (newDb == db)
+			continue;
+		const float mul = obs_db_to_mul(newDb);
+		it->volumeSender.Sent(mul);
+		it->volumeSetCount++;
+		obs_source_set_volume(it->source, mul);
+		if (it->volControl) {
+			const QSignalBlocker blocker(it->slider);
+			it->slider->setValue(fader_db_to_def(it->faderLaw, newDb) * 10000.0f);
+			it->UpdateVolumeToolTip(newDb);
+		}
+	}
 }
 
 bool SourceDock::GetSourceRelativeXY(int mouseX, int mouseY, int &relX, int &relY)
@@ -1416,20 +1557,35 @@ bool SourceDock::PreviewEnabled()
 	return preview != nullptr && preview->isVisibleTo(this);
 }
 
-void SourceDock::EnableVolMeter()
+void SourceDock::CreateVolmeter()
 {
-	if (obs_volmeter != nullptr)
+	if (obs_volmeter)
 		return;
-
 	obs_volmeter = obs_volmeter_create(OBS_FADER_LOG);
 	if (source)
 		obs_volmeter_attach_source(obs_volmeter, source);
+	obs_volmeter_add_callback(obs_volmeter, OBSVolumeLevel, this);
+}
 
+void SourceDock::DestroyVolmeter()
+{
+	if (!obs_volmeter)
+		return;
+	obs_volmeter_remove_callback(obs_volmeter, OBSVolumeLevel, this);
+	obs_volmeter_destroy(obs_volmeter);
+	obs_volmeter = nullptr;
+}
+
+void SourceDock::EnableVolMeter()
+{
+	if (volMeter != nullptr)
+		return;
+
+	// The volmeter is shared with the silence alarm.
+	CreateVolmeter();
 	volMeter = new VolumeMeter(nullptr, obs_volmeter);
 	volMeter->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
 
-	obs_volmeter_add_callback(obs_volmeter, OBSVolumeLevel, this);
-
 	if (volMeterWidget) {
 		volMeterWidget->layout()->addWidget(volMeter);
 		volMeterWidget->setVisible(true);
@@ -1439,17 +1595,22 @@ void SourceDock::EnableVolMeter()
 	volMeterWidget = new QWidget;
 	volMeterWidget->setLayout(volMeterLayout);
 	volMeterWidget->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
+	volMeterWidget->setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(volMeterWidget, &QWidget::customContextMenuRequested, this, &SourceDock::ContextMenuRequested);
 	volMeterLayout->addWidget(volMeter);
 	addWidget(volMeterWidget);
 }
 
 void SourceDock::DisableVolMeter()
 {
-	if (!obs_volmeter)
+	if (!volMeter)
 		return;
 
 	volMeterWidget->setVisible(false);
+	DisableLevelHistory();
 
+	// Removing the callback waits for a running one, so the audio thread no
+	// longer uses the meter once it is added back for the silence alarm.
 	obs_volmeter_remove_callback(obs_volmeter, OBSVolumeLevel, this);
 
 	auto layout = volMeterWidget->layout();
@@ -1459,13 +1620,62 @@ void SourceDock::DisableVolMeter()
 	volMeter->deleteLater();
 	volMeter = nullptr;
 
+	if (silenceAlarm) {
+		obs_volmeter_add_callback(obs_volmeter, OBSVolumeLevel, this);
+		return;
+	}
 	obs_volmeter_destroy(obs_volmeter);
 	obs_volmeter = nullptr;
 }
 
 bool SourceDock::VolMeterEnabled()
 {
-	return obs_volmeter != nullptr;
+	return volMeter != nullptr;
+}
+
+void SourceDock::EnableLevelHistory()
+{
+	if (levelHistory != nullptr || obs_volmeter == nullptr)
+		return;
+
+	const auto history = new LevelHistory(nullptr, obs_volmeter);
+	history->SetSeconds(levelHistorySeconds);
+	volMeterWidget->layout()->addWidget(history);
+
+	// The volmeter callback reads the pointer on the audio thread, only
+	// change it while the callback is removed.
+	obs_volmeter_remove_callback(obs_volmeter, OBSVolumeLevel, this);
+	levelHistory = history;
+	obs_volmeter_add_callback(obs_volmeter, OBSVolumeLevel, this);
+}
+
+void SourceDock::DisableLevelHistory()
+{
+	if (!levelHistory)
+		return;
+
+	const auto history = levelHistory;
+	obs_volmeter_remove_callback(obs_volmeter, OBSVolumeLevel, this);
+	levelHistory = nullptr;
+	obs_volmeter_add_callback(obs_volmeter, OBSVolumeLevel, this);
+
+	levelHistorySeconds = history->GetSeconds();
+	volMeterWidget->layout()->removeWidget(history);
+	history->deleteLater();
+}
+
+bool SourceDock::LevelHistoryEnabled()
+{
+	return levelHistory != nullptr;
+}
+
+void SourceDock::SetLevelHistorySeconds(int seconds)
+{
+	if (seconds <= 0)
+		return;
+	levelHistorySeconds = seconds;
+	if (levelHistory)
+		levelHistory->SetSeconds(seconds);
 }
 
 void SourceDock::UpdateVolControls()
@@ -1481,16 +1691,13 @@ void SourceDock::UpdateVolControls()
 	mute->setEnabled(!lock);
 	mute->setChecked(source ? obs_source_muted(source) : false);
 	slider->setEnabled(!lock);
+	volumeTimer->stop();
+	volumeSender.Reset();
 	float mul = source ? obs_source_get_volume(source) : 0.0f;
 	float db = obs_mul_to_db(mul);
-	float def;
-	if (db >= 0.0f)
-		def = 1.0f;
-	else if (db <= -96.0f)
-		def = 0.0f;
-	else
-		def = (-log10f(-db + LOG_OFFSET_DB) - LOG_RANGE_VAL) / (LOG_OFFSET_VAL - LOG_RANGE_VAL);
-	slider->setValue(def * 10000.0f);
+	const QSignalBlocker blocker(slider);
+	slider->setValue(fader_db_to_def(faderLaw, db) * 10000.0f);
+	UpdateVolumeToolTip(db);
 }
 
 void SourceDock::EnableVolControls()
@@ -1505,8 +1712,17 @@ void SourceDock::EnableVolControls()
 		return;
 	}
 
+	struct obs_audio_info oai;
+	obs_get_audio_info(&oai);
+	volumeTimer = new QTimer(this);
+	volumeTimer->setTimerType(Qt::PreciseTimer);
+	volumeTimer->setInterval((int)(AUDIO_OUTPUT_FRAMES * 1000 / (oai.samples_per_sec ? oai.samples_per_sec : 48000)));
+	connect(volumeTimer, &QTimer::timeout, [this]() { SendVolume(); });
+
 	volControl = new QWidget;
 	volControl->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
+	volControl->setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(volControl, &QWidget::customContextMenuRequested, this, &SourceDock::ContextMenuRequested);
 	auto *audioLayout = new QHBoxLayout(this);
 
 	locked = new LockedCheckBox();
@@ -1563,6 +1779,7 @@ void SourceDock::DisableVolControls()
 		signal_handler_disconnect(sh, "volume", OBSVolume, this);
 	}
 	volControl->setVisible(false);
+	LogVolumeSignalCounts();
 }
 bool SourceDock::VolControlsEnabled()
 {
@@ -1696,48 +1913,18 @@ void SourceDock::EnableSceneItems()
 	if (!scene)
 		return;
 	if (!sceneItems) {
-		sceneItemsScrollArea = new QScrollArea;
-		sceneItemsScrollArea->setObjectName(QString::fromUtf8("vScrollArea"));
-		sceneItemsScrollArea->setFrameShape(QFrame::StyledPanel);
-		sceneItemsScrollArea->setFrameShadow(QFrame::Sunken);
-		sceneItemsScrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
-		sceneItemsScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-		sceneItemsScrollArea->setWidgetResizable(true);
-		sceneItemsScrollArea->setContentsMargins(0, 0, 0, 0);
-
-		auto layout = new QGridLayout;
-		sceneItems = new QWidget;
-		sceneItems->setContentsMargins(0, 0, 0, 0);
-		sceneItems->setObjectName(QStringLiteral("contextContainer"));
-		sceneItems->setLayout(layout);
-		layout->setColumnStretch(0, 1);
-		sceneItems->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Maximum);
-
-		sceneItemsScrollArea->setWidget(sceneItems);
-		addWidget(sceneItemsScrollArea);
-
+		sceneItems = new SceneItemList;
+		addWidget(sceneItems);
 	} else {
 		sceneItems->setVisible(true);
-		sceneItemsScrollArea->setVisible(true);
 	}
-	int count = 0;
-	obs_scene_enum_items(scene, GetSceneItemCount, &count);
-	sceneItems->layout()->setProperty("sceneItemCount", count);
-	sceneItems->layout()->setProperty("row", 0);
-	sceneItems->layout()->setProperty("indent", 0);
-	obs_scene_enum_items(scene, AddSceneItem, sceneItems->layout());
-
-	auto itemVisible = [](void *data, calldata_t *cd) {
-		const auto dock = static_cast<SourceDock *>(data);
-		const auto curItem = static_cast<obs_sceneitem_t *>(calldata_ptr(cd, "item"));
-
-		const int id = (int)obs_sceneitem_get_id(curItem);
-		QMetaObject::invokeMethod(dock, "VisibilityChanged", Qt::QueuedConnection, Q_ARG(int, id));
-	};
+	sceneItems->SetScene(scene);
 
 	auto refreshItems = [](void *data, calldata_t *cd) {
 		UNUSED_PARAMETER(cd);
 		const auto dock = static_cast<SourceDock *>(data);
+		if (!dock->sceneItemsRefresh.Signal())
+			return;
 		QMetaObject::invokeMethod(dock, "RefreshItems", Qt::QueuedConnection);
 	};
 
@@ -1747,113 +1934,46 @@ void SourceDock::EnableSceneItems()
 	removeSignal.Connect(signal, "item_remove", refreshItems, this);
 	reorderSignal.Connect(signal, "reorder", refreshItems, this);
 	refreshSignal.Connect(signal, "refresh", refreshItems, this);
-	visibleSignal.Connect(signal, "item_visible", itemVisible, this);
+	visibleSignal.Connect(signal, "item_visible", OBSItemVisible, this);
+	ConnectGroupSignals();
 }
 
-void SourceDock::VisibilityChanged(int id)
+void SourceDock::OBSItemVisible(void *data, calldata_t *cd)
 {
-	auto layout = dynamic_cast<QGridLayout *>(sceneItems->layout());
-	auto count = layout->rowCount();
-
-	for (int i = 0; i < count; i++) {
-		QLayoutItem *item = layout->itemAtPosition(i, 3);
-		if (!item)
-			continue;
-		QWidget *w = item->widget();
-		if (!w)
-			continue;
-		if (id != w->property("id").toInt())
-			continue;
-		auto scene = obs_scene_from_source(source);
-		if (!scene)
-			scene = obs_group_from_source(source);
-		obs_sceneitem_t *sceneitem = obs_scene_find_sceneitem_by_id(scene, id);
+	const auto dock = static_cast<SourceDock *>(data);
+	const auto curItem = static_cast<obs_sceneitem_t *>(calldata_ptr(cd, "item"));
 
-		auto checkBox = dynamic_cast<QCheckBox *>(w);
-		checkBox->setChecked(obs_sceneitem_visible(sceneitem));
-	}
+	const int id = (int)obs_sceneitem_get_id(curItem);
+	QMetaObject::invokeMethod(dock, "VisibilityChanged", Qt::QueuedConnection, Q_ARG(int, id));
 }
 
-void SourceDock::RefreshItems()
+void SourceDock::ConnectGroupSignals()
 {
-	DisableSceneItems();
-	EnableSceneItems();
+	// Group members signal their visibility on the group, not on the scene.
+	groupVisibleSignals.clear();
+	const std::vector<obs_source_t *> groups = sceneItems->Groups();
+	groupVisibleSignals.reserve(groups.size());
+	for (obs_source_t *group : groups)
+		groupVisibleSignals.emplace_back(obs_source_get_signal_handler(group), "item_visible", OBSItemVisible, this);
 }
 
-bool SourceDock::GetSceneItemCount(obs_scene_t *scene, obs_sceneitem_t *item, void *data)
+void SourceDock::VisibilityChanged(int id)
 {
-	UNUSED_PARAMETER(scene);
-	int *count = (int *)data;
-	if (obs_sceneitem_is_group(item))
-		obs_scene_enum_items(obs_group_from_source(obs_sceneitem_get_source(item)), GetSceneItemCount, count);
-	(*count)++;
-	return true;
+	if (sceneItems)
+		sceneItems->VisibilityChanged(id);
 }
 
-bool SourceDock::AddSceneItem(obs_scene_t *scene, obs_sceneitem_t *item, void *data)
+void SourceDock::RefreshItems()
 {
-	UNUSED_PARAMETER(scene);
-	QGridLayout *layout = static_cast<QGridLayout *>(data);
-	int indent = layout->property("indent").toInt();
-	if (obs_sceneitem_is_group(item)) {
-		indent++;
-		layout->setProperty("indent", indent);
-		obs_scene_enum_items(obs_group_from_source(obs_sceneitem_get_source(item)), AddSceneItem, data);
-		indent--;
-		layout->setProperty("indent", indent);
-	}
-
-	auto source = obs_sceneitem_get_source(item);
-	int sceneItemCount = layout->property("sceneItemCount").toInt();
-	int row = layout->property("row").toInt();
-	row++;
-	layout->setProperty("row", row);
-	row = sceneItemCount - row;
-	auto name = QString(indent * 4, ' ') + QT_UTF8(obs_source_get_name(source));
-	auto label = new QLabel(name);
-	layout->addWidget(label, row, 0, Qt::AlignLeft | Qt::AlignVCenter);
-
-	if (obs_is_source_configurable(obs_source_get_id(source))) {
-		auto prop = new QPushButton();
-		prop->setObjectName(QStringLiteral("sourcePropertiesButton"));
-		prop->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
-		prop->setFixedSize(16, 16);
-		prop->setFlat(true);
-		layout->addWidget(prop, row, 1, Qt::AlignCenter);
-
-		auto openProps = [source]() {
-			obs_frontend_open_source_properties(source);
-		};
-		connect(prop, &QAbstractButton::clicked, openProps);
-	}
-
-	auto filters = new QPushButton();
-	filters->setObjectName(QStringLiteral("sourceFiltersButton"));
-	filters->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
-	filters->setFixedSize(16, 16);
-	filters->setFlat(true);
-	layout->addWidget(filters, row, 2, Qt::AlignCenter);
-
-	auto openFilters = [source]() {
-		obs_frontend_open_source_filters(source);
-	};
-
-	connect(filters, &QAbstractButton::clicked, openFilters);
-
-	auto vis = new VisibilityCheckBox();
-	vis->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Maximum);
-	vis->setFixedSize(16, 16);
-	vis->setChecked(obs_sceneitem_visible(item));
-	vis->setStyleSheet("background: none");
-	vis->setProperty("id", (int)obs_sceneitem_get_id(item));
-	layout->addWidget(vis, row, 3, Qt::AlignCenter);
-
-	auto setItemVisible = [item](bool val) {
-		obs_sceneitem_set_visible(item, val);
-	};
-
-	connect(vis, &QAbstractButton::clicked, setItemVisible);
-	return true;
+	sceneItemsRefresh.Begin();
+	if (!SceneItemsEnabled())
+		return;
+	obs_scene_t *scene = obs_scene_from_source(source);
+	if (!scene)
+		scene = obs_group_from_source(source);
+	// Applies the differences to the list instead of rebuilding it.
+	sceneItems->SetScene(scene);
+	ConnectGroupSignals();
 }
 
 void SourceDock::DisableSceneItems()
@@ -1861,19 +1981,27 @@ void SourceDock::DisableSceneItems()
 	if (!sceneItems)
 		return;
 
-	sceneItemsScrollArea->setVisible(false);
 	sceneItems->setVisible(false);
-	const auto layout = sceneItems->layout();
-	for (auto i = layout->count() - 1; i >= 0; i--) {
-		auto item = layout->takeAt(i);
-		layout->removeWidget(item->widget());
-		delete item->widget();
-	}
+	sceneItems->Clear();
 	visibleSignal.Disconnect();
 	addSignal.Disconnect();
 	removeSignal.Disconnect();
 	reorderSignal.Disconnect();
 	refreshSignal.Disconnect();
+	groupVisibleSignals.clear();
+	LogSceneItemSignalCounts();
+}
+
+void SourceDock::LogSceneItemSignalCounts()
+{
+	uint64_t count, refreshes;
+	sceneItemsRefresh.TakeCounts(count, refreshes);
+	if (!count)
+		return;
+	blog(LOG_INFO, "[Source Dock] '%s' received %llu scene item signals, refreshed %llu times", QT_TO_UTF8(windowTitle()),
+	     (unsigned long long)count, (unsigned long long)refreshes);
+	scene_item_signals += count;
+	scene_item_refreshes += refreshes;
 }
 bool SourceDock::SceneItemsEnabled()
 {
@@ -1937,6 +2065,302 @@ bool SourceDock::FiltersEnabled()
 	return filtersButton != nullptr && filtersButton->isVisibleTo(this);
 }
 
+void SourceDock::SilenceLevel(const float peak[MAX_AUDIO_CHANNELS])
+{
+	const uint64_t ts = os_gettime_ns();
+	silenceLastData.store(ts, std::memory_order_relaxed);
+
+	float level = peak[0];
+	for (int channelNr = 1; channelNr < MAX_AUDIO_CHANNELS; channelNr++) {
+		if (peak[channelNr] > level)
+			level = peak[channelNr];
+	}
+	if (level >= silenceThreshold.load(std::memory_order_relaxed) ||
+	    !silenceSourceActive.load(std::memory_order_relaxed)) {
+		silenceStart.store(ts, std::memory_order_relaxed);
+		SetSilenceDetected(false);
+	} else if (ts - silenceStart.load(std::memory_order_relaxed) >=
+		   (uint64_t)silenceDuration.load(std::memory_order_relaxed) * 1000000000ULL) {
+		SetSilenceDetected(true);
+	}
+}
+
+void SourceDock::OBSSilenceActivate(void *data, calldata_t *calldata)
+{
+	UNUSED_PARAMETER(calldata);
+	SourceDock *sourceDock = static_cast<SourceDock *>(data);
+	sourceDock->silenceSourceActive = true;
+}
+
+void SourceDock::OBSSilenceDeactivate(void *data, calldata_t *calldata)
+{
+	UNUSED_PARAMETER(calldata);
+	SourceDock *sourceDock = static_cast<SourceDock *>(data);
+	sourceDock->silenceSourceActive = false;
+	sourceDock->SetSilenceDetected(false);
+}
+
+void SourceDock::SetSilenceDetected(bool detected)
+{
+	// Only notify the UI on a state transition, never per buffer.
+	bool expected = !detected;
+	if (!silenceDetected.compare_exchange_strong(expected, detected))
+		return;
+	QMetaObject::invokeMethod(this, "SilenceChanged", Qt::QueuedConnection, Q_ARG(bool, detected));
+}
+
+void SourceDock::SilenceChanged(bool detected)
+{
+	if (!silenceLabel)
+		return;
+	if (detected && silenceAlarm) {
+		blog(LOG_WARNING, "[Source Dock] silence detected on '%s' for %d seconds below %.1f dB",
+		     obs_source_get_name(source), silenceDuration.load(), (double)silenceThreshold.load());
+		silenceLabel->setVisible(true);
+	} else {
+		if (silenceLabel->isVisibleTo(this))
+			blog(LOG_INFO, "[Source Dock] audio restored on '%s'", obs_source_get_name(source));
+		silenceLabel->setVisible(false);
+	}
+}
+
+void SourceDock::ConnectSilenceSource()
+{
+	const uint64_t ts = os_gettime_ns();
+	silenceStart = ts;
+	silenceLastData = ts;
+	silenceSourceActive = false;
+	SetSilenceDetected(false);
+	if (!source)
+		return;
+	signal_handler_t *sh = obs_source_get_signal_handler(source);
+	signal_handler_connect(sh, "activate", OBSSilenceActivate, this);
+	signal_handler_connect(sh, "deactivate", OBSSilenceDeactivate, this);
+	silenceSourceActive = obs_source_active(source);
+}
+
+void SourceDock::DisconnectSilenceSource()
+{
+	if (source) {
+		signal_handler_t *sh = obs_source_get_signal_handler(source);
+		signal_handler_disconnect(sh, "activate", OBSSilenceActivate, this);
+		signal_handler_disconnect(sh, "deactivate", OBSSilenceDeactivate, this);
+	}
+	silenceSourceActive = false;
+	SetSilenceDetected(false);
+}
+
+void SourceDock::EnableSilenceAlarm()
+{
+	if (silenceAlarm)
+		return;
+	if (source && !(obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO))
+		return;
+
+	if (!silenceLabel) {
+		silenceLabel = new QLabel(QT_UTF8(obs_module_text("SilenceDetected")));
+		silenceLabel->setAlignment(Qt::AlignCenter);
+		silenceLabel->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
+		silenceLabel->setProperty("themeID", "error");
+		silenceLabel->setProperty("class", "text-danger");
+		addWidget(silenceLabel);
+	}
+	silenceLabel->setVisible(false);
+
+	ConnectSilenceSource();
+	// Fed from the volmeter of the volume meter, created here when that is
+	// not enabled.
+	silenceAlarm = true;
+	CreateVolmeter();
+
+	// Sources that stop delivering audio do not trigger the volmeter callback at all.
+	if (!silenceTimer) {
+		silenceTimer = new QTimer(this);
+		connect(silenceTimer, &QTimer::timeout, this, [this]() {
+			if (!silenceAlarm || !silenceSourceActive)
+				return;
+			const uint64_t ts = os_gettime_ns();
+			if (ts - silenceLastData.load() >= (uint64_t)silenceDuration.load() * 1000000000ULL)
+				SetSilenceDetected(true);
+		});
+	}
+	silenceTimer->start(1000);
+}
+
+void SourceDock::DisableSilenceAlarm()
+{
+	if (!silenceAlarm)
+		return;
+	silenceTimer->stop();
+	silenceAlarm = false;
+	DisconnectSilenceSource();
+	if (!volMeter)
+		DestroyVolmeter();
+	silenceLabel->setVisible(false);
+}
+
+bool SourceDock::SilenceAlarmEnabled()
+{
+	return silenceAlarm;
+}
+
+void SourceDock::SetSilenceDuration(int seconds)
+{
+	if (seconds <= 0)
+		return;
+	silenceDuration = seconds;
+}
+
+void SourceDock::EnableSpectrum()
+{
+	if (spectrum)
+		return;
+
+	spectrum = new SpectrumAnalyzer;
+	spectrum->SetSource(source);
+	addWidget(spectrum);
+}
+
+void SourceDock::DisableSpectrum()
+{
+	if (!spectrum)
+		return;
+
+	spectrum->SetSource(nullptr);
+	spectrum->setVisible(false);
+	spectrum->deleteLater();
+	spectrum = nullptr;
+}
+
+bool SourceDock::SpectrumEnabled()
+{
+	return spectrum != nullptr;
+}
+
+void SourceDock::EnablePhaseMeter()
+{
+	if (phaseMeter)
+		return;
+
+	phaseMeter = new PhaseMeter;
+	phaseMeter->SetGoniometer(phaseMeterGoniometer);
+	phaseMeter->SetSource(source);
+	addWidget(phaseMeter);
+}
+
+void SourceDock::DisablePhaseMeter()
+{
+	if (!phaseMeter)
+		return;
+
+	phaseMeterGoniometer = phaseMeter->GetGoniometer();
+	phaseMeter->SetSource(nullptr);
+	phaseMeter->setVisible(false);
+	phaseMeter->deleteLater();
+	phaseMeter = nullptr;
+}
+
+bool SourceDock::PhaseMeterEnabled()
+{
+	return phaseMeter != nullptr;
+}
+
+void SourceDock::SetGoniometer(bool enable)
+{
+	phaseMeterGoniometer = enable;
+	if (phaseMeter)
+		phaseMeter->SetGoniometer(enable);
+}
+
+void SourceDock::EnableTrackMeters()
+{
+	if (trackMeters)
+		return;
+
+	trackMeters = new TrackMeters;
+	trackMeters->SetTracks(trackMeterTracks);
+	addWidget(trackMeters);
+}
+
+void SourceDock::DisableTrackMeters()
+{
+	if (!trackMeters)
+		return;
+
+	trackMeterTracks = trackMeters->GetTracks();
+	trackMeters->SetTracks(0);
+	trackMeters->setVisible(false);
+	trackMeters->deleteLater();
+	trackMeters = nullptr;
+}
+
+bool SourceDock::TrackMetersEnabled()
+{
+	return trackMeters != nullptr;
+}
+
+void SourceDock::SetTrackMeterTracks(uint32_t tracks)
+{
+	trackMeterTracks = tracks;
+	if (trackMeters)
+		trackMeters->SetTracks(tracks);
+}
+
+void SourceDock::ContextMenuRequested()
+{
+	QMenu menu;
+	auto silenceMenu = menu.addMenu(QT_UTF8(obs_module_text("SilenceAlarm")));
+	auto a = silenceMenu->addAction(QT_UTF8(obs_module_text("Enabled")), [this]() {
+		if (SilenceAlarmEnabled())
+			DisableSilenceAlarm();
+		else
+			EnableSilenceAlarm();
+	});
+	a->setCheckable(true);
+	a->setChecked(SilenceAlarmEnabled());
+	silenceMenu->addSeparator();
+	for (int threshold : {-40, -50, -60, -70}) {
+		a = silenceMenu->addAction(QString::fromUtf8(obs_module_text("SilenceThreshold")).arg(threshold),
+					   [this, threshold]() { SetSilenceThreshold((float)threshold); });
+		a->setCheckable(true);
+		a->setChecked((int)silenceThreshold.load() == threshold);
+	}
+	silenceMenu->addSeparator();
+	for (int duration : {2, 5, 10, 30}) {
+		a = silenceMenu->addAction(QString::fromUtf8(obs_module_text("SilenceDuration")).arg(duration),
+					   [this, duration]() { SetSilenceDuration(duration); });
+		a->setCheckable(true);
+		a->setChecked(silenceDuration.load() == duration);
+	}
+	auto faderLawMenu = menu.addMenu(QT_UTF8(obs_module_text("FaderLaw")));
+	faderLawMenu->setEnabled(VolControlsEnabled());
+	for (int law = 0; law < FADER_LAW_COUNT; law++) {
+		a = faderLawMenu->addAction(QT_UTF8(obs_module_text(fader_law_name(law))), [this, law]() { SetFaderLaw(law); });
+		a->setCheckable(true);
+		a->setChecked(faderLaw == law);
+	}
+	auto faderGroupMenu = menu.addMenu(QT_UTF8(obs_module_text("FaderGroup")));
+	faderGroupMenu->setEnabled(VolControlsEnabled());
+	for (int group = 0; group <= FADER_GROUPS; group++) {
+		a = faderGroupMenu->addAction(group ? QString::fromUtf8(obs_module_text("FaderGroupNr")).arg(group)
+						    : QT_UTF8(obs_module_text("None")),
+					      [this, group]() { SetFaderGroup(group); });
+		a->setCheckable(true);
+		a->setChecked(faderGroup == group);
+	}
+	a = menu.addAction(QT_UTF8(obs_module_text("VolumeRamp")), [this]() { SetVolumeRamp(!volumeRamp); });
+	a->setCheckable(true);
+	a->setChecked(volumeRamp);
+	a->setEnabled(VolControlsEnabled());
+	a = menu.addAction(QT_UTF8(obs_module_text("SyncOffset")), [this]() {
+		const auto dialog = new SyncOffsetDialog(source, static_cast<QMainWindow *>(obs_frontend_get_main_window()));
+		dialog->setAttribute(Qt::WA_DeleteOnClose, true);
+		dialog->show();
+	});
+	a->setEnabled(source && (obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO) != 0);
+	menu.exec(QCursor::pos());
+}
+
 static inline QColor color_from_int(long long val)
 {
 	return QColor(val & 0xff, (val >> 8) & 0xff, (val >> 16) & 0xff, (val >> 24) & 0xff);
@@ -2163,6 +2587,8 @@ void SourceDock::SetSource(const OBSSource source_)
 
 	if (obs_volmeter)
 		obs_volmeter_detach_source(obs_volmeter);
+	if (silenceAlarm)
+		DisconnectSilenceSource();
 
 	if (volControl && volControl->isVisibleTo(this) && source) {
 		auto sh = obs_source_get_signal_handler(source);
@@ -2172,6 +2598,11 @@ void SourceDock::SetSource(const OBSSource source_)
 
 	source = source_;
 
+	if (spectrum)
+		spectrum->SetSource(source);
+	if (phaseMeter)
+		phaseMeter->SetSource(source);
+
 	UpdateVolControls();
 	ActiveChanged();
 
@@ -2203,6 +2634,8 @@ void SourceDock::SetSource(const OBSSource source_)
 
 	if (obs_volmeter)
 		obs_volmeter_attach_source(obs_volmeter, source);
+	if (silenceAlarm)
+		ConnectSilenceSource();
 
 	if (preview && preview->isVisibleTo(this))
 		obs_source_inc_showing(source);
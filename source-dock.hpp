@@ -6,6 +6,7 @@
 #include <QSlider>
 #include <QPlainTextEdit>
 #include <QScrollArea>
+#include <atomic>
 #include <memory>
 
 #include "obs.h"
@@ -16,6 +17,14 @@
 #include "obs.hpp"
 #include "qt-display.hpp"
 #include "volume-meter.hpp"
+#include "level-history.hpp"
+#include "spectrum-analyzer.hpp"
+#include "phase-meter.hpp"
+#include "track-meter.hpp"
+#include "fader-law.hpp"
+#include "volume-sender.hpp"
+#include "coalesced-refresh.hpp"
+#include "scene-item-list.hpp"
 
 #define SHOW_PREVIEW 1
 #define SHOW_AUDIO 2
@@ -88,6 +97,8 @@ private:
 
 	OBSQTDisplay *preview = nullptr;
 	VolumeMeter *volMeter = nullptr;
+	LevelHistory *levelHistory = nullptr;
+	int levelHistorySeconds = 30;
 	QWidget *volMeterWidget = nullptr;
 	obs_volmeter_t *obs_volmeter = nullptr;
 	LockedCheckBox *locked = nullptr;
@@ -100,19 +111,60 @@ private:
 	bool switch_scene_enabled = false;
 	QFrame *activeFrame = nullptr;
 	QLabel *activeLabel = nullptr;
-	QWidget *sceneItems = nullptr;
-	QScrollArea *sceneItemsScrollArea = nullptr;
+	int activeFrameStyle = -1;
+	int activeLabelStyle = -1;
+	int recordedActive = -1;
+	// Only used by the volume meter callback.
+	uint32_t levelRecordCounter = 0;
+	SceneItemList *sceneItems = nullptr;
 	QPushButton *propertiesButton = nullptr;
 	QPushButton *filtersButton = nullptr;
 	QPlainTextEdit *textInput = nullptr;
 	QTimer *textInputTimer = nullptr;
 	obs_data_t *textInputCustomStyle = nullptr;
 
+	// Latest volume and mute from the source signals, applied by at most
+	// one pending UI event per dock.
+	std::atomic<float> pendingVolume{0.0f};
+	std::atomic<bool> pendingMute{false};
+	std::atomic<int> pendingVolumeUpdates{0};
+	std::atomic<uint64_t> volumeSignalCount{0};
+	std::atomic<uint64_t> volumeSignalCoalesced{0};
+
+	// Scene item signals only queue a refresh when none is pending.
+	CoalescedRefresh sceneItemsRefresh;
+
+	// Slider changes are sent to the source at most once per audio tick.
+	QTimer *volumeTimer = nullptr;
+	VolumeSender volumeSender;
+	bool volumeRamp = false;
+	int faderLaw = FADER_LAW_LOG;
+	int faderGroup = 0;
+	uint64_t volumeSetCount = 0;
+
+	// Written on the UI thread, read by the volmeter callback.
+	std::atomic<bool> silenceAlarm{false};
+	QLabel *silenceLabel = nullptr;
+	QTimer *silenceTimer = nullptr;
+	std::atomic<float> silenceThreshold{-50.0f};
+	std::atomic<int> silenceDuration{5};
+	std::atomic<uint64_t> silenceStart{0};
+	std::atomic<uint64_t> silenceLastData{0};
+	std::atomic<bool> silenceSourceActive{false};
+	std::atomic<bool> silenceDetected{false};
+
+	SpectrumAnalyzer *spectrum = nullptr;
+	PhaseMeter *phaseMeter = nullptr;
+	bool phaseMeterGoniometer = false;
+	TrackMeters *trackMeters = nullptr;
+	uint32_t trackMeterTracks = (1 << MAX_AUDIO_MIXES) - 1;
+
 	OBSSignal visibleSignal;
 	OBSSignal addSignal;
 	OBSSignal removeSignal;
 	OBSSignal reorderSignal;
 	OBSSignal refreshSignal;
+	std::vector<OBSSignal> groupVisibleSignals;
 
 	static void DrawPreview(void *data, uint32_t cx, uint32_t cy);
 
@@ -120,9 +172,23 @@ private:
 				   const float inputPeak[MAX_AUDIO_CHANNELS]);
 	static void OBSVolume(void *data, calldata_t *calldata);
 	static void OBSMute(void *data, calldata_t *calldata);
+	static void OBSItemVisible(void *data, calldata_t *calldata);
+	void QueueVolumeUpdate(int update);
+	void ApplyPendingVolumeUpdates();
+	void LogVolumeSignalCounts();
+	void ConnectGroupSignals();
+	void SendVolume();
+	void UpdateVolumeToolTip(float db);
+	void ApplyGroupVolume(float deltaDb);
 	static void OBSActiveChanged(void *, calldata_t *);
-	static bool AddSceneItem(obs_scene_t *scene, obs_sceneitem_t *item, void *data);
-	static bool GetSceneItemCount(obs_scene_t *scene, obs_sceneitem_t *item, void *data);
+	void SilenceLevel(const float peak[MAX_AUDIO_CHANNELS]);
+	static void OBSSilenceActivate(void *data, calldata_t *calldata);
+	static void OBSSilenceDeactivate(void *data, calldata_t *calldata);
+	void SetSilenceDetected(bool detected);
+	void CreateVolmeter();
+	void DestroyVolmeter();
+	void ConnectSilenceSource();
+	void DisconnectSilenceSource();
 	bool GetSourceRelativeXY(int mouseX, int mouseY, int &x, int &y);
 
 	bool HandleMouseClickEvent(QMouseEvent *event);
@@ -142,7 +208,8 @@ private slots:
 	void ActiveChanged();
 	void VisibilityChanged(int id);
 	void RefreshItems();
-	void SetActive(int active);
+	void SilenceChanged(bool detected);
+	void ContextMenuRequested();
 
 public:
 	SourceDock(QString name, bool selected, QWidget *parent = nullptr);
@@ -163,6 +230,12 @@ public:
 	void DisableVolMeter();
 	bool VolMeterEnabled();
 
+	void EnableLevelHistory();
+	void DisableLevelHistory();
+	bool LevelHistoryEnabled();
+	int GetLevelHistorySeconds() { return levelHistory ? levelHistory->GetSeconds() : levelHistorySeconds; }
+	void SetLevelHistorySeconds(int seconds);
+
 	void EnableVolControls();
 	void UpdateVolControls();
 	void DisableVolControls();
@@ -183,10 +256,12 @@ public:
 	void EnableShowActive();
 	void DisableShowActive();
 	bool ShowActiveEnabled();
+	void SetActive(int active);
 
 	void EnableSceneItems();
 	void DisableSceneItems();
 	bool SceneItemsEnabled();
+	void LogSceneItemSignalCounts();
 
 	void EnableProperties();
 	void DisableProperties();
@@ -196,6 +271,37 @@ public:
 	void DisableFilters();
 	bool FiltersEnabled();
 
+	void EnableSilenceAlarm();
+	void DisableSilenceAlarm();
+	bool SilenceAlarmEnabled();
+	float GetSilenceThreshold() { return silenceThreshold.load(); }
+	void SetSilenceThreshold(float threshold) { silenceThreshold = threshold; }
+	int GetSilenceDuration() { return silenceDuration.load(); }
+	void SetSilenceDuration(int seconds);
+
+	bool GetVolumeRamp() { return volumeRamp; }
+	void SetVolumeRamp(bool ramp) { volumeRamp = ramp; }
+	int GetFaderLaw() { return faderLaw; }
+	void SetFaderLaw(int law);
+	int GetFaderGroup() { return faderGroup; }
+	void SetFaderGroup(int group) { faderGroup = group; }
+
+	void EnableSpectrum();
+	void DisableSpectrum();
+	bool SpectrumEnabled();
+
+	void EnablePhaseMeter();
+	void DisablePhaseMeter();
+	bool PhaseMeterEnabled();
+	bool GetGoniometer() { return phaseMeter ? phaseMeter->GetGoniometer() : phaseMeterGoniometer; }
+	void SetGoniometer(bool enable);
+
+	void EnableTrackMeters();
+	void DisableTrackMeters();
+	bool TrackMetersEnabled();
+	uint32_t GetTrackMeterTracks() { return trackMeters ? trackMeters->GetTracks() : trackMeterTracks; }
+	void SetTrackMeterTracks(uint32_t tracks);
+
 	void EnableTextInput();
 	void DisableTextInput();
 	bool TextInputEnabled();
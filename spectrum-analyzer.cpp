@@ -0,0 +1,190 @@
+#include "spectrum-analyzer.hpp"
+#include "volume-meter.hpp"
+
+#include <obs-module.h>
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define SPECTRUM_WARNING_LEVEL -20.0f
+#define SPECTRUM_ERROR_LEVEL -9.0f
+
+SpectrumAnalyzer::SpectrumAnalyzer(QWidget *parent)
+	: QWidget(parent),
+	  fft(SPECTRUM_FFT_SIZE),
+	  window(SPECTRUM_FFT_SIZE),
+	  samples(SPECTRUM_FFT_SIZE),
+	  channelSamples(SPECTRUM_FFT_SIZE),
+	  spectrum(SPECTRUM_FFT_SIZE)
+{
+	setAttribute(Qt::WA_OpaquePaintEvent, true);
+	setMinimumSize(130, 48);
+	setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
+
+	for (int ch = 0; ch < SPECTRUM_CHANNELS; ch++)
+		rings[ch] = std::make_unique<AudioRing>(SPECTRUM_FFT_SIZE * 2);
+
+	// Hann window
+	for (int i = 0; i < SPECTRUM_FFT_SIZE; i++)
+		window[i] = 0.5f * (1.0f - (float)cos(2.0 * M_PI * double(i) / double(SPECTRUM_FFT_SIZE - 1)));
+
+	// Logarithmically spaced bands from 20 Hz up to the Nyquist frequency.
+	struct obs_audio_info oai;
+	obs_get_audio_info(&oai);
+	const double nyquist = double(oai.samples_per_sec) / 2.0;
+	const double binWidth = double(oai.samples_per_sec) / double(SPECTRUM_FFT_SIZE);
+	for (int band = 0; band <= SPECTRUM_BANDS; band++) {
+		const double frequency =
+			SPECTRUM_MIN_FREQUENCY * pow(nyquist / SPECTRUM_MIN_FREQUENCY, double(band) / double(SPECTRUM_BANDS));
+		bandBins[band] = std::min((int)(frequency / binWidth), SPECTRUM_FFT_SIZE / 2);
+	}
+	for (int band = 0; band < SPECTRUM_BANDS; band++) {
+		bandLevels[band] = SPECTRUM_MINIMUM_LEVEL;
+		levels[band] = SPECTRUM_MINIMUM_LEVEL;
+		paintLevels[band] = SPECTRUM_MINIMUM_LEVEL;
+	}
+
+	AnalysisWorker::AddTask(this);
+	updateTimerRef = VolumeMeter::GetUpdateTimer();
+	updateTimerRef->AddVolControl(this);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+	updateTimerRef->RemoveVolControl(this);
+	SetSource(nullptr);
+	AnalysisWorker::RemoveTask(this);
+}
+
+void SpectrumAnalyzer::SetSource(obs_source_t *source_)
+{
+	if (source_ == source)
+		return;
+	if (source)
+		obs_source_remove_audio_capture_callback(source, OBSAudioCapture, this);
+	channels = 0;
+	for (int ch = 0; ch < SPECTRUM_CHANNELS; ch++)
+		rings[ch]->Reset();
+
+	source = source_;
+	if (!source || (obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO) == 0)
+		return;
+
+	channels = std::min((int)audio_output_get_channels(obs_get_audio()), SPECTRUM_CHANNELS);
+	obs_source_add_audio_capture_callback(source, OBSAudioCapture, this);
+}
+
+void SpectrumAnalyzer::OBSAudioCapture(void *param, obs_source_t *source, const struct audio_data *audio_data, bool muted)
+{
+	UNUSED_PARAMETER(source);
+	UNUSED_PARAMETER(muted);
+	auto analyzer = static_cast<SpectrumAnalyzer *>(param);
+	const int nrChannels = analyzer->channels;
+	for (int ch = 0; ch < nrChannels; ch++) {
+		if (audio_data->data[ch])
+			analyzer->rings[ch]->Write((const float *)audio_data->data[ch], audio_data->frames,
+						   audio_data->timestamp);
+	}
+}
+
+void SpectrumAnalyzer::Process(uint64_t ts)
+{
+	const float seconds = lastProcessTime ? float(ts - lastProcessTime) / 1000000000.0f : 0.0f;
+	lastProcessTime = ts;
+
+	const int nrChannels = channels;
+	bool fresh = false;
+	if (nrChannels > 0) {
+		const uint64_t written = rings[0]->Written();
+		if (written != lastWritten) {
+			lastWritten = written;
+			fresh = true;
+			std::fill(samples.begin(), samples.end(), 0.0f);
+			for (int ch = 0; ch < nrChannels && fresh; ch++) {
+				fresh = rings[ch]->ReadLatest(channelSamples.data(), SPECTRUM_FFT_SIZE);
+				for (int i = 0; i < SPECTRUM_FFT_SIZE; i++)
+					samples[i] += channelSamples[i];
+			}
+		}
+	}
+
+	if (fresh) {
+		const float scale = 1.0f / float(nrChannels);
+		for (int i = 0; i < SPECTRUM_FFT_SIZE; i++)
+			spectrum[i] = std::complex<float>(samples[i] * scale * window[i], 0.0f);
+		fft.Forward(spectrum.data());
+	}
+
+	// A full scale sine shows up as N / 4 in a Hann windowed transform.
+	const float offset = 20.0f * log10f(4.0f / float(SPECTRUM_FFT_SIZE));
+	const float decay = SPECTRUM_DECAY_RATE * seconds;
+	for (int band = 0; band < SPECTRUM_BANDS; band++) {
+		float level = SPECTRUM_MINIMUM_LEVEL;
+		if (fresh) {
+			const int first = bandBins[band];
+			const int last = std::max(bandBins[band + 1], first + 1);
+			float power = 0.0f;
+			for (int bin = first; bin < last && bin <= SPECTRUM_FFT_SIZE / 2; bin++)
+				power = std::max(power, std::norm(spectrum[bin]));
+			if (power > 0.0f)
+				level = 10.0f * log10f(power) + offset;
+		}
+		bandLevels[band] = std::max(std::max(level, bandLevels[band] - decay), SPECTRUM_MINIMUM_LEVEL);
+	}
+
+	QMutexLocker locker(&levelsMutex);
+	std::copy(bandLevels, bandLevels + SPECTRUM_BANDS, levels);
+}
+
+void SpectrumAnalyzer::paintBars()
+{
+	if (paintCache.size() != size())
+		paintCache = QImage(size(), QImage::Format_RGB32);
+	paintCache.fill(palette().color(QPalette::ColorRole::Window));
+
+	QPainter painter(&paintCache);
+	const int w = width();
+	const int h = height();
+	for (int band = 0; band < SPECTRUM_BANDS; band++) {
+		const float level = paintLevels[band];
+		if (!(level > SPECTRUM_MINIMUM_LEVEL))
+			continue;
+		const int barHeight = std::min(h, int((level - SPECTRUM_MINIMUM_LEVEL) / -SPECTRUM_MINIMUM_LEVEL * float(h)));
+		const int x = band * w / SPECTRUM_BANDS;
+		const int barWidth = std::max((band + 1) * w / SPECTRUM_BANDS - x - 1, 1);
+
+		QColor color;
+		if (level < SPECTRUM_WARNING_LEVEL)
+			color.setRgb(0x4c, 0xff, 0x4c);
+		else if (level < SPECTRUM_ERROR_LEVEL)
+			color.setRgb(0xff, 0xff, 0x4c);
+		else
+			color.setRgb(0xff, 0x4c, 0x4c);
+		painter.fillRect(x, h - barHeight, barWidth, barHeight, color);
+	}
+}
+
+void SpectrumAnalyzer::paintEvent(QPaintEvent *event)
+{
+	UNUSED_PARAMETER(event);
+	if (width() <= 0 || height() <= 0)
+		return;
+
+	float current[SPECTRUM_BANDS];
+	levelsMutex.lock();
+	std::copy(levels, levels + SPECTRUM_BANDS, current);
+	levelsMutex.unlock();
+
+	// Only redraw the bars when the levels or the size changed.
+	if (paintCache.size() != size() || !std::equal(current, current + SPECTRUM_BANDS, paintLevels)) {
+		std::copy(current, current + SPECTRUM_BANDS, paintLevels);
+		paintBars();
+	}
+
+	QPainter painter(this);
+	painter.drawImage(0, 0, paintCache);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QWidget>
+#include <atomic>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include <obs.hpp>
+
+#include "analysis-worker.hpp"
+#include "audio-ring.hpp"
+#include "fft.hpp"
+
+#define SPECTRUM_FFT_SIZE 2048
+#define SPECTRUM_BANDS 48
+#define SPECTRUM_CHANNELS 2
+#define SPECTRUM_MIN_FREQUENCY 20.0
+#define SPECTRUM_MINIMUM_LEVEL -90.0f
+#define SPECTRUM_DECAY_RATE 40.0f
+
+class VolumeMeterTimer;
+
+class SpectrumAnalyzer : public QWidget, public AnalysisTask {
+	Q_OBJECT
+
+private:
+	OBSSource source;
+	QSharedPointer<VolumeMeterTimer> updateTimerRef;
+
+	// Written by the audio thread, only a copy of the planes.
+	std::unique_ptr<AudioRing> rings[SPECTRUM_CHANNELS];
+	std::atomic<int> channels{0};
+
+	// Only used on the analysis thread.
+	FFT fft;
+	std::vector<float> window;
+	std::vector<float> samples;
+	std::vector<float> channelSamples;
+	std::vector<std::complex<float>> spectrum;
+	int bandBins[SPECTRUM_BANDS + 1];
+	float bandLevels[SPECTRUM_BANDS];
+	uint64_t lastWritten = 0;
+	uint64_t lastProcessTime = 0;
+
+	QMutex levelsMutex;
+	float levels[SPECTRUM_BANDS];
+
+	// Only used while painting.
+	QImage paintCache;
+	float paintLevels[SPECTRUM_BANDS];
+
+	static void OBSAudioCapture(void *param, obs_source_t *source, const struct audio_data *audio_data, bool muted);
+
+	void paintBars();
+
+public:
+	explicit SpectrumAnalyzer(QWidget *parent = nullptr);
+	~SpectrumAnalyzer();
+
+	void SetSource(obs_source_t *source);
+
+	void Process(uint64_t ts) override;
+
+protected:
+	void paintEvent(QPaintEvent *event) override;
+};
@@ -0,0 +1,328 @@
+#include "sync-offset.hpp"
+
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <algorithm>
+#include <cmath>
+
+#include <obs-module.h>
+
+#ifndef QT_UTF8
+#define QT_UTF8(str) QString::fromUtf8(str)
+#endif
+#ifndef QT_TO_UTF8
+#define QT_TO_UTF8(str) str.toUtf8().constData()
+#endif
+
+SyncCapture::SyncCapture(obs_source_t *source_, size_t ringSize) : source(source_), ring(ringSize)
+{
+	struct obs_audio_info oai;
+	obs_get_audio_info(&oai);
+	channels = audio_output_get_channels(obs_get_audio());
+	sampleRate = oai.samples_per_sec;
+}
+
+SyncOffsetDialog::SyncOffsetDialog(obs_source_t *source, QWidget *parent)
+	: QDialog(parent),
+	  referenceCombo(new QComboBox()),
+	  adjustCombo(new QComboBox()),
+	  durationSpin(new QSpinBox()),
+	  continuousCheckBox(new QCheckBox(QT_UTF8(obs_module_text("Continuous")))),
+	  estimateButton(new QPushButton(QT_UTF8(obs_module_text("Estimate")))),
+	  applyButton(new QPushButton(QT_UTF8(obs_module_text("Apply")))),
+	  resultLabel(new QLabel())
+{
+	setWindowTitle(QT_UTF8(obs_module_text("SyncOffsetEstimator")));
+
+	obs_enum_sources(AddSource, referenceCombo);
+	obs_enum_sources(AddSource, adjustCombo);
+	if (source) {
+		const auto index = referenceCombo->findText(QT_UTF8(obs_source_get_name(source)));
+		if (index >= 0)
+			referenceCombo->setCurrentIndex(index);
+		if (adjustCombo->count() > 1)
+			adjustCombo->setCurrentIndex(index == 0 ? 1 : 0);
+	}
+
+	durationSpin->setMinimum(2);
+	durationSpin->setMaximum(10);
+	durationSpin->setValue(3);
+	durationSpin->setSuffix(" s");
+
+	applyButton->setEnabled(false);
+	resultLabel->setWordWrap(true);
+
+	auto layout = new QGridLayout;
+	layout->addWidget(new QLabel(QT_UTF8(obs_module_text("ReferenceSource"))), 0, 0);
+	layout->addWidget(referenceCombo, 0, 1);
+	layout->addWidget(new QLabel(QT_UTF8(obs_module_text("AdjustSource"))), 1, 0);
+	layout->addWidget(adjustCombo, 1, 1);
+	layout->addWidget(new QLabel(QT_UTF8(obs_module_text("CaptureDuration"))), 2, 0);
+	layout->addWidget(durationSpin, 2, 1);
+	layout->addWidget(continuousCheckBox, 3, 1);
+	layout->addWidget(resultLabel, 4, 0, 1, 2);
+
+	auto buttonLayout = new QHBoxLayout;
+	buttonLayout->addStretch();
+	buttonLayout->addWidget(estimateButton);
+	buttonLayout->addWidget(applyButton);
+	layout->addLayout(buttonLayout, 5, 0, 1, 2);
+	setLayout(layout);
+
+	connect(estimateButton, &QPushButton::clicked, [this] { EstimateClicked(); });
+	connect(applyButton, &QPushButton::clicked, [this] { ApplyClicked(); });
+	connect(&captureTimer, &QTimer::timeout, [this] { RunEstimate(); });
+	connect(referenceCombo, &QComboBox::currentIndexChanged, [this] { StopCapture(); });
+	connect(adjustCombo, &QComboBox::currentIndexChanged, [this] { StopCapture(); });
+	connect(continuousCheckBox, &QCheckBox::toggled, [this](bool checked) {
+		if (!checked && captureTimer.isActive() && !captureTimer.isSingleShot())
+			StopCapture();
+	});
+}
+
+SyncOffsetDialog::~SyncOffsetDialog()
+{
+	StopCapture();
+	if (worker.joinable())
+		worker.join();
+}
+
+bool SyncOffsetDialog::AddSource(void *data, obs_source_t *source)
+{
+	if ((obs_source_get_output_flags(source) & OBS_SOURCE_AUDIO) == 0)
+		return true;
+	auto combo = static_cast<QComboBox *>(data);
+	combo->addItem(QT_UTF8(obs_source_get_name(source)));
+	return true;
+}
+
+void SyncOffsetDialog::OBSAudioCapture(void *param, obs_source_t *source, const struct audio_data *audio_data, bool muted)
+{
+	UNUSED_PARAMETER(source);
+	UNUSED_PARAMETER(muted);
+	auto capture = static_cast<SyncCapture *>(param);
+	const float scale = 1.0f / float(capture->channels * SYNC_DECIMATION);
+	const double frameDuration = 1000000000.0 / double(capture->sampleRate);
+
+	float out[256];
+	size_t count = 0;
+	for (uint32_t i = 0; i < audio_data->frames; i++) {
+		for (uint32_t ch = 0; ch < capture->channels; ch++) {
+			if (audio_data->data[ch])
+				capture->accumulator += ((const float *)audio_data->data[ch])[i];
+		}
+		if (++capture->accumulated < SYNC_DECIMATION)
+			continue;
+		out[count++] = capture->accumulator * scale;
+		capture->accumulator = 0.0f;
+		capture->accumulated = 0;
+		if (count == sizeof(out) / sizeof(out[0])) {
+			capture->ring.Write(out, count, audio_data->timestamp + (uint64_t)(double(i + 1) * frameDuration));
+			count = 0;
+		}
+	}
+	if (count)
+		capture->ring.Write(out, count,
+				    audio_data->timestamp +
+					    (uint64_t)(double(audio_data->frames - (uint32_t)capture->accumulated) * frameDuration));
+}
+
+void SyncOffsetDialog::StartCapture()
+{
+	StopCapture();
+
+	obs_source_t *referenceSource = obs_get_source_by_name(QT_TO_UTF8(referenceCombo->currentText()));
+	obs_source_t *adjustSource = obs_get_source_by_name(QT_TO_UTF8(adjustCombo->currentText()));
+	if (referenceSource && adjustSource && referenceSource != adjustSource) {
+		struct obs_audio_info oai;
+		obs_get_audio_info(&oai);
+		const size_t ringSize = (size_t)oai.samples_per_sec / SYNC_DECIMATION * (size_t)durationSpin->maximum() * 2;
+		reference = std::make_unique<SyncCapture>(referenceSource, ringSize);
+		adjust = std::make_unique<SyncCapture>(adjustSource, ringSize);
+		obs_source_add_audio_capture_callback(referenceSource, OBSAudioCapture, reference.get());
+		obs_source_add_audio_capture_callback(adjustSource, OBSAudioCapture, adjust.get());
+		captureTimer.setSingleShot(!continuousCheckBox->isChecked());
+		captureTimer.start(continuousCheckBox->isChecked() ? SYNC_CONTINUOUS_INTERVAL_MS
+								   : durationSpin->value() * 1000 + 100);
+		resultLabel->setText(QT_UTF8(obs_module_text("SyncOffsetCapturing")));
+	}
+	obs_source_release(referenceSource);
+	obs_source_release(adjustSource);
+}
+
+void SyncOffsetDialog::StopCapture()
+{
+	captureTimer.stop();
+	if (reference) {
+		obs_source_remove_audio_capture_callback(reference->source, OBSAudioCapture, reference.get());
+		reference.reset();
+	}
+	if (adjust) {
+		obs_source_remove_audio_capture_callback(adjust->source, OBSAudioCapture, adjust.get());
+		adjust.reset();
+	}
+}
+
+void SyncOffsetDialog::EstimateClicked()
+{
+	estimateValid = false;
+	applyButton->setEnabled(false);
+	StartCapture();
+}
+
+void SyncOffsetDialog::ApplyClicked()
+{
+	if (!estimateValid)
+		return;
+	obs_source_t *source = obs_get_source_by_name(QT_TO_UTF8(adjustCombo->currentText()));
+	if (!source)
+		return;
+	const int64_t offset = obs_source_get_sync_offset(source) - estimatedOffset;
+	obs_source_set_sync_offset(source, offset);
+	blog(LOG_INFO, "[Source Dock] sync offset of '%s' set to %lld ms", obs_source_get_name(source),
+	     (long long)(offset / 1000000));
+	obs_source_release(source);
+	estimateValid = false;
+	applyButton->setEnabled(false);
+	// The rings hold audio from before the change, start over.
+	if (continuousCheckBox->isChecked())
+		StartCapture();
+}
+
+void SyncOffsetDialog::RunEstimate()
+{
+	if (!reference || !adjust)
+		return;
+	if (workerBusy.load())
+		return;
+
+	const size_t count = (size_t)(reference->sampleRate / SYNC_DECIMATION) * (size_t)durationSpin->value();
+	std::vector<float> a(count);
+	std::vector<float> b(count);
+	uint64_t referenceEnd = 0;
+	uint64_t adjustEnd = 0;
+	if (!reference->ring.ReadLatest(a.data(), count, &referenceEnd) || !adjust->ring.ReadLatest(b.data(), count, &adjustEnd)) {
+		resultLabel->setText(QT_UTF8(obs_module_text("SyncOffsetNoAudio")));
+		if (!continuousCheckBox->isChecked())
+			StopCapture();
+		return;
+	}
+	const double samplePeriod = 1000000000.0 / double(reference->sampleRate / SYNC_DECIMATION);
+	const size_t maxLag = std::min(count / 2, (size_t)(SYNC_MAX_LAG_MS * 1000000.0 / samplePeriod));
+	const double timestampDiff = double((int64_t)(adjustEnd - referenceEnd));
+
+	if (!continuousCheckBox->isChecked())
+		StopCapture();
+
+	const size_t fftSize = FFT::NextPowerOfTwo(count * 2);
+	if (!fft || fft->Size() != fftSize)
+		fft = std::make_shared<const FFT>(fftSize);
+
+	if (worker.joinable())
+		worker.join();
+	workerBusy = true;
+	worker = std::thread([this, f = fft, a = std::move(a), b = std::move(b), maxLag, samplePeriod, timestampDiff] {
+		double lag = 0.0;
+		double correlation = 0.0;
+		const bool ok = Estimate(*f, a, b, maxLag, lag, correlation);
+		const double offsetMs = (timestampDiff + lag * samplePeriod) / 1000000.0;
+		workerBusy = false;
+		QMetaObject::invokeMethod(this, "EstimateDone", Qt::QueuedConnection, Q_ARG(bool, ok), Q_ARG(double, offsetMs),
+					  Q_ARG(double, correlation));
+	});
+}
+
+// Generalized cross-correlation with phase transform. Both real signals are
+// packed into one complex FFT, so an estimate costs one forward and one
+// inverse transform.
+bool SyncOffsetDialog::Estimate(const FFT &fft, const std::vector<float> &a, const std::vector<float> &b, size_t maxLag,
+				double &lag, double &correlation)
+{
+	const size_t n = a.size();
+	const size_t size = fft.Size();
+	const size_t mask = size - 1;
+	if (n == 0 || b.size() != n || size < n * 2)
+		return false;
+
+	double meanA = 0.0;
+	double meanB = 0.0;
+	for (size_t i = 0; i < n; i++) {
+		meanA += a[i];
+		meanB += b[i];
+	}
+	meanA /= double(n);
+	meanB /= double(n);
+
+	std::vector<std::complex<float>> packed(size);
+	for (size_t i = 0; i < n; i++)
+		packed[i] = std::complex<float>(a[i] - (float)meanA, b[i] - (float)meanB);
+	fft.Forward(packed.data());
+
+	std::vector<std::complex<float>> cross(size);
+	for (size_t k = 0; k < size; k++) {
+		const std::complex<float> x = packed[k];
+		const std::complex<float> xr = std::conj(packed[(size - k) & mask]);
+		const std::complex<float> specA = (x + xr) * 0.5f;
+		const std::complex<float> specB = (x - xr) * std::complex<float>(0.0f, -0.5f);
+		const std::complex<float> c = std::conj(specA) * specB;
+		const float magnitude = std::abs(c);
+		cross[k] = magnitude > 1e-12f ? c / magnitude : std::complex<float>(0.0f, 0.0f);
+	}
+	fft.Inverse(cross.data());
+
+	// cross[l] peaks where b[i + l] matches a[i], negative lags wrap around.
+	long best = 0;
+	float bestValue = -1.0f;
+	for (long l = -(long)maxLag; l <= (long)maxLag; l++) {
+		const float value = cross[(size_t)l & mask].real();
+		if (value > bestValue) {
+			bestValue = value;
+			best = l;
+		}
+	}
+	if (bestValue <= 0.0f)
+		return false;
+
+	// Parabolic interpolation for a sub-sample lag.
+	const float left = cross[(size_t)(best - 1) & mask].real();
+	const float right = cross[(size_t)(best + 1) & mask].real();
+	const float denominator = left - 2.0f * bestValue + right;
+	lag = double(best);
+	if (denominator < 0.0f)
+		lag += 0.5 * double(left - right) / double(denominator);
+
+	// Normalized correlation of the overlapping part at the integer lag.
+	double sum = 0.0;
+	double energyA = 0.0;
+	double energyB = 0.0;
+	const size_t start = best < 0 ? (size_t)-best : 0;
+	const size_t end = best > 0 ? n - (size_t)best : n;
+	for (size_t i = start; i < end; i++) {
+		const double va = a[i] - meanA;
+		const double vb = b[(size_t)((long)i + best)] - meanB;
+		sum += va * vb;
+		energyA += va * va;
+		energyB += vb * vb;
+	}
+	if (energyA <= 0.0 || energyB <= 0.0)
+		return false;
+	correlation = sum / sqrt(energyA * energyB);
+	return true;
+}
+
+void SyncOffsetDialog::EstimateDone(bool ok, double offsetMs, double correlation)
+{
+	if (!ok) {
+		resultLabel->setText(QT_UTF8(obs_module_text("SyncOffsetFailed")));
+		return;
+	}
+	estimatedOffset = (int64_t)(offsetMs * 1000000.0);
+	estimateValid = true;
+	// A negative offset means the adjusted source is ahead of the reference.
+	resultLabel->setText(QT_UTF8(obs_module_text(offsetMs < 0.0 ? "SyncOffsetResultAhead" : "SyncOffsetResult"))
+				     .arg(adjustCombo->currentText())
+				     .arg(fabs(offsetMs), 0, 'f', 1)
+				     .arg(referenceCombo->currentText())
+				     .arg(correlation, 0, 'f', 2));
+	applyButton->setEnabled(true);
+}
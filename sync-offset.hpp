@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialog>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <obs.hpp>
+
+#include "audio-ring.hpp"
+#include "fft.hpp"
+
+// Captured audio is downmixed to mono and decimated before it goes into the
+// ring, 48 kHz becomes 12 kHz which is plenty for a sub-millisecond estimate.
+#define SYNC_DECIMATION 4
+#define SYNC_MAX_LAG_MS 1000
+#define SYNC_CONTINUOUS_INTERVAL_MS 10000
+
+struct SyncCapture {
+	OBSSource source;
+	AudioRing ring;
+	uint32_t channels;
+	uint32_t sampleRate;
+
+	// Only used on the audio thread.
+	float accumulator = 0.0f;
+	int accumulated = 0;
+
+	SyncCapture(obs_source_t *source, size_t ringSize);
+};
+
+class SyncOffsetDialog : public QDialog {
+	Q_OBJECT
+
+private:
+	QComboBox *referenceCombo;
+	QComboBox *adjustCombo;
+	QSpinBox *durationSpin;
+	QCheckBox *continuousCheckBox;
+	QPushButton *estimateButton;
+	QPushButton *applyButton;
+	QLabel *resultLabel;
+	QTimer captureTimer;
+
+	std::unique_ptr<SyncCapture> reference;
+	std::unique_ptr<SyncCapture> adjust;
+
+	std::thread worker;
+	std::atomic<bool> workerBusy{false};
+	std::shared_ptr<const FFT> fft;
+
+	int64_t estimatedOffset = 0;
+	bool estimateValid = false;
+
+	static void OBSAudioCapture(void *param, obs_source_t *source, const struct audio_data *audio_data, bool muted);
+	static bool AddSource(void *data, obs_source_t *source);
+	static bool Estimate(const FFT &fft, const std::vector<float> &a, const std::vector<float> &b, size_t maxLag,
+			     double &lag, double &correlation);
+
+	void StartCapture();
+	void StopCapture();
+	void RunEstimate();
+	void EstimateClicked();
+	void ApplyClicked();
+
+private slots:
+	void EstimateDone(bool ok, double offsetMs, double correlation);
+
+public:
+	SyncOffsetDialog(obs_source_t *source, QWidget *parent = nullptr);
+	~SyncOffsetDialog();
+};
@@ -0,0 +1,147 @@
+#include "tally-server.hpp"
+#include "tally.hpp"
+
+#include <obs-module.h>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+// A client that stops reading is dropped instead of buffering forever.
+#define TALLY_CLIENT_MAX_BUFFER (64 * 1024)
+#define TALLY_SERVER_PROBE_TIMEOUT_MS 100
+
+static const char *tally_state_name(int state)
+{
+	switch (state) {
+	case ACTIVE_PREVIEW:
+		return "preview";
+	case ACTIVE_PROGRAM:
+		return "program";
+	case ACTIVE_DOWNSTREAM_KEYER:
+		return "dsk";
+	case ACTIVE_STREAMING:
+		return "streaming";
+	case ACTIVE_RECORDING:
+		return "recording";
+	case ACTIVE_RECORDING_AND_STREAMING:
+		return "streaming+recording";
+	case ACTIVE_RECORDING_PAUSED:
+		return "recording-paused";
+	default:
+		return "none";
+	}
+}
+
+static QByteArray tally_line(const char *state, const QByteArray &uuid, const char *name)
+{
+	QByteArray line(state);
+	line += '\t';
+	line += uuid;
+	line += '\t';
+	// Keep the protocol one line per event whatever the source is called.
+	line += QByteArray(name ? name : "").replace('\t', ' ').replace('\n', ' ').replace('\r', ' ');
+	line += '\n';
+	return line;
+}
+
+TallyServer::TallyServer(QObject *parent) : QObject(parent), server(new QLocalServer(this))
+{
+	server->setSocketOptions(QLocalServer::UserAccessOption);
+	connect(server, &QLocalServer::newConnection, this, &TallyServer::NewConnection);
+}
+
+TallyServer::~TallyServer()
+{
+	for (auto client : clients) {
+		disconnect(client, nullptr, this, nullptr);
+		client->abort();
+	}
+	server->close();
+}
+
+bool TallyServer::Listen()
+{
+	bool listening = server->listen(TALLY_SERVER_NAME);
+	if (!listening && server->serverError() == QAbstractSocket::AddressInUseError) {
+		// A crashed instance can leave a stale socket file behind. Only
+		// remove it when nothing answers, another running instance keeps
+		// its socket.
+		QLocalSocket probe;
+		probe.connectToServer(TALLY_SERVER_NAME);
+		if (!probe.waitForConnected(TALLY_SERVER_PROBE_TIMEOUT_MS)) {
+			QLocalServer::removeServer(TALLY_SERVER_NAME);
+			listening = server->listen(TALLY_SERVER_NAME);
+		} else {
+			probe.abort();
+		}
+	}
+	if (!listening) {
+		blog(LOG_WARNING, "[Source Dock] tally export failed to listen on '%s': %s", TALLY_SERVER_NAME,
+		     server->errorString().toUtf8().constData());
+		return false;
+	}
+	blog(LOG_INFO, "[Source Dock] tally export listening on '%s'", server->fullServerName().toUtf8().constData());
+	return true;
+}
+
+void TallyServer::NewConnection()
+{
+	while (QLocalSocket *client = server->nextPendingConnection()) {
+		clients.append(client);
+		connect(client, &QLocalSocket::disconnected, this, [this, client]() {
+			clients.removeAll(client);
+			client->deleteLater();
+		});
+		// The protocol is one way, anything a client sends is ignored.
+		connect(client, &QLocalSocket::readyRead, client, [client]() { client->readAll(); });
+
+		QByteArray snapshot;
+		for (auto it = lines.cbegin(); it != lines.cend(); ++it)
+			snapshot += it.value();
+		if (!snapshot.isEmpty()) {
+			client->write(snapshot);
+			client->flush();
+		}
+	}
+}
+
+void TallyServer::Send(const QByteArray &data)
+{
+	for (auto client : QList<QLocalSocket *>(clients)) {
+		if (client->bytesToWrite() > TALLY_CLIENT_MAX_BUFFER) {
+			client->abort();
+			continue;
+		}
+		client->write(data);
+		client->flush();
+	}
+}
+
+void TallyServer::Publish(const std::vector<obs_source_t *> &sources, const std::vector<int> &states)
+{
+	QByteArray changes;
+	QHash<QByteArray, QByteArray> current;
+	current.reserve((qsizetype)sources.size());
+	for (size_t i = 0; i < sources.size() && i < states.size(); i++) {
+		if (!sources[i])
+			continue;
+		const QByteArray uuid(obs_source_get_uuid(sources[i]));
+		if (current.contains(uuid))
+			continue;
+		QByteArray line = tally_line(tally_state_name(states[i]), uuid, obs_source_get_name(sources[i]));
+		auto previous = lines.constFind(uuid);
+		if (previous == lines.cend() || previous.value() != line)
+			changes += line;
+		current.insert(uuid, line);
+	}
+	for (auto it = lines.cbegin(); it != lines.cend(); ++it) {
+		if (current.contains(it.key()))
+			continue;
+		const QByteArray &line = it.value();
+		const qsizetype nameStart = line.indexOf('\t', line.indexOf('\t') + 1) + 1;
+		changes += tally_line(tally_state_name(ACTIVE_NONE), it.key(),
+				      line.mid(nameStart, line.size() - nameStart - 1).constData());
+	}
+	lines.swap(current);
+	if (!changes.isEmpty())
+		Send(changes);
+}
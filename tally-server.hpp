@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <vector>
+
+#include "obs.h"
+
+#define TALLY_SERVER_NAME "obs-source-dock-tally"
+
+class QLocalServer;
+class QLocalSocket;
+
+// Publishes the tally state of every dock source on a local socket (a Unix
+// domain socket, or a named pipe on Windows). Each change is pushed as one
+// line "<state>\t<uuid>\t<name>\n", new clients first get the current state
+// of every source.
+class TallyServer : public QObject {
+	Q_OBJECT
+
+private:
+	QLocalServer *server;
+	QList<QLocalSocket *> clients;
+	QHash<QByteArray, QByteArray> lines;
+
+	void Send(const QByteArray &data);
+
+private slots:
+	void NewConnection();
+
+public:
+	explicit TallyServer(QObject *parent = nullptr);
+	~TallyServer();
+
+	bool Listen();
+
+	// Sends the sources whose state changed since the last call, sources
+	// that are gone are sent as "none" once.
+	void Publish(const std::vector<obs_source_t *> &sources, const std::vector<int> &states);
+};
+
+inline TallyServer *tally_server = nullptr;
+
+// Starts or stops the tally server, defined with the dock bookkeeping.
+void set_tally_export(bool enable);
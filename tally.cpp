@@ -0,0 +1,298 @@
+#include "tally.hpp"
+#include "scene-snapshot.hpp"
+
+#include <obs-frontend-api.h>
+#include <algorithm>
+#include <iterator>
+
+static const char *scene_signals[] = {"item_add", "item_remove", "item_visible", "refresh"};
+static const char *transition_signals[] = {"transition_start", "transition_stop"};
+
+static const int root_states[] = {ACTIVE_PREVIEW, ACTIVE_DOWNSTREAM_KEYER, ACTIVE_PROGRAM};
+
+TallyEngine::TallyEngine(void (*changed_)()) : changed(changed_) {}
+
+std::string TallyEngine::PrivateKey(obs_source_t *source)
+{
+	std::string key = obs_source_get_unversioned_id(source);
+	key += '\n';
+	if (const char *name = obs_source_get_name(source))
+		key += name;
+	return key;
+}
+
+static void add_child(obs_source_t *, obs_source_t *child, void *param)
+{
+	static_cast<std::vector<obs_source_t *> *>(param)->push_back(child);
+}
+
+std::vector<obs_source_t *> TallyEngine::GetChildren(obs_source_t *source)
+{
+	std::vector<obs_source_t *> children;
+	if (obs_scene_t *scene = obs_group_or_scene_from_source(source)) {
+		std::vector<SceneItemEntry> entries;
+		snapshot_scene(scene, 0, entries);
+		children.reserve(entries.size());
+		for (const auto &entry : entries) {
+			if (entry.flags & SCENE_ITEM_VISIBLE)
+				children.push_back(entry.source);
+		}
+	} else {
+		// Only what the source shows right now, a transition shows both
+		// of its sources while it runs.
+		obs_source_enum_active_sources(source, add_child, &children);
+	}
+	std::sort(children.begin(), children.end());
+	return children;
+}
+
+void TallyEngine::SceneChanged(void *data, calldata_t *call_data)
+{
+	auto engine = static_cast<TallyEngine *>(data);
+	auto scene = static_cast<obs_scene_t *>(calldata_ptr(call_data, "scene"));
+	if (!scene)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(engine->dirtyMutex);
+		engine->dirty.insert(obs_scene_get_source(scene));
+	}
+	engine->changed();
+}
+
+void TallyEngine::TransitionChanged(void *data, calldata_t *call_data)
+{
+	UNUSED_PARAMETER(call_data);
+	// Source nodes are checked on every update.
+	static_cast<TallyEngine *>(data)->changed();
+}
+
+void TallyEngine::Connect(obs_source_t *source, const Node &node, bool connect)
+{
+	signal_handler_t *sh = obs_source_get_signal_handler(source);
+	if (node.scene) {
+		for (const char *signal : scene_signals) {
+			if (connect)
+				signal_handler_connect(sh, signal, SceneChanged, this);
+			else
+				signal_handler_disconnect(sh, signal, SceneChanged, this);
+		}
+	} else if (node.transition) {
+		for (const char *signal : transition_signals) {
+			if (connect)
+				signal_handler_connect(sh, signal, TransitionChanged, this);
+			else
+				signal_handler_disconnect(sh, signal, TransitionChanged, this);
+		}
+	}
+}
+
+void TallyEngine::AddReach(int root, obs_source_t *source, int count)
+{
+	auto it = reach[root].find(source);
+	if (it == reach[root].end()) {
+		if (count < 0)
+			return;
+		it = reach[root].emplace(source, Reach()).first;
+		if (obs_obj_is_private(source))
+			it->second.privateKey = PrivateKey(source);
+	}
+	it->second.count += count;
+	if (!it->second.privateKey.empty()) {
+		int &privateCount = privateReach[root][it->second.privateKey];
+		privateCount += count;
+		if (privateCount <= 0)
+			privateReach[root].erase(it->second.privateKey);
+	}
+	if (it->second.count <= 0)
+		reach[root].erase(it);
+
+	auto nodeIt = nodes.find(source);
+	if (nodeIt == nodes.end()) {
+		if (count < 0)
+			return;
+		Node node;
+		node.scene = obs_group_or_scene_from_source(source) != nullptr;
+		node.transition = obs_source_get_type(source) == OBS_SOURCE_TYPE_TRANSITION;
+		node.children = GetChildren(source);
+		// Sources that show nothing stay leaves, except transitions that
+		// can start showing a scene at any time.
+		if (!node.scene && !node.transition && node.children.empty())
+			return;
+		if (!obs_source_get_ref(source))
+			return;
+		Connect(source, node, true);
+		if (!node.scene)
+			sourceNodes.insert(source);
+		nodeIt = nodes.emplace(source, std::move(node)).first;
+	}
+	// Elements stay in place when the map grows, the reference survives the
+	// recursion. Only nodes below this one can be erased.
+	Node &node = nodeIt->second;
+	node.count += count;
+	for (auto child : node.children)
+		AddReach(root, child, count);
+	if (node.count > 0)
+		return;
+	Connect(source, node, false);
+	sourceNodes.erase(source);
+	nodes.erase(nodeIt);
+	obs_source_release(source);
+}
+
+void TallyEngine::SetRoots(obs_source_t *sources[ROOT_COUNT][MAX_CHANNELS])
+{
+	// Add all new roots before removing the old ones so nodes that move
+	// between roots, like scenes swapped by a studio mode transition, keep
+	// their cached children.
+	for (int root = 0; root < ROOT_COUNT; root++) {
+		for (size_t index = 0; index < MAX_CHANNELS; index++) {
+			if (sources[root][index] && sources[root][index] != roots[root][index])
+				AddReach(root, sources[root][index], 1);
+		}
+	}
+	for (int root = 0; root < ROOT_COUNT; root++) {
+		for (size_t index = 0; index < MAX_CHANNELS; index++) {
+			obs_source_t *previous = roots[root][index];
+			obs_source_t *source = sources[root][index];
+			roots[root][index] = source;
+			if (previous == source) {
+				obs_source_release(source);
+				continue;
+			}
+			if (previous) {
+				AddReach(root, previous, -1);
+				obs_source_release(previous);
+			}
+		}
+	}
+}
+
+void TallyEngine::RefreshNode(obs_source_t *source)
+{
+	auto nodeIt = nodes.find(source);
+	if (nodeIt == nodes.end())
+		return;
+	Node &node = nodeIt->second;
+	std::vector<obs_source_t *> children = GetChildren(source);
+	std::vector<obs_source_t *> added;
+	std::vector<obs_source_t *> removed;
+	std::set_difference(children.begin(), children.end(), node.children.begin(), node.children.end(),
+			    std::back_inserter(added));
+	std::set_difference(node.children.begin(), node.children.end(), children.begin(), children.end(),
+			    std::back_inserter(removed));
+	if (added.empty() && removed.empty())
+		return;
+	node.children = std::move(children);
+	for (int root = 0; root < ROOT_COUNT; root++) {
+		auto it = reach[root].find(source);
+		if (it == reach[root].end())
+			continue;
+		const int count = it->second.count;
+		for (auto child : added)
+			AddReach(root, child, count);
+		for (auto child : removed)
+			AddReach(root, child, -count);
+	}
+}
+
+void TallyEngine::RefreshPrivateKey(obs_source_t *source)
+{
+	for (int root = 0; root < ROOT_COUNT; root++) {
+		auto it = reach[root].find(source);
+		if (it == reach[root].end() || it->second.privateKey.empty())
+			continue;
+		std::string privateKey = PrivateKey(source);
+		if (privateKey == it->second.privateKey)
+			continue;
+		const int count = it->second.count;
+		int &previousCount = privateReach[root][it->second.privateKey];
+		previousCount -= count;
+		if (previousCount <= 0)
+			privateReach[root].erase(it->second.privateKey);
+		privateReach[root][privateKey] += count;
+		it->second.privateKey = std::move(privateKey);
+	}
+}
+
+void TallyEngine::Update()
+{
+	std::unordered_set<obs_source_t *> changedScenes;
+	std::unordered_set<obs_source_t *> renamedSources;
+	{
+		std::lock_guard<std::mutex> lock(dirtyMutex);
+		changedScenes.swap(dirty);
+		renamedSources.swap(renamed);
+	}
+	for (auto scene : changedScenes)
+		RefreshNode(scene);
+	// Refreshing can release nodes, iterate over a copy.
+	const std::vector<obs_source_t *> sources(sourceNodes.begin(), sourceNodes.end());
+	for (auto source : sources)
+		RefreshNode(source);
+	// Only sources that are still reached are looked at.
+	for (auto source : renamedSources)
+		RefreshPrivateKey(source);
+
+	obs_source_t *current[ROOT_COUNT][MAX_CHANNELS] = {};
+	current[ROOT_PREVIEW][0] = obs_frontend_get_current_preview_scene();
+	for (uint32_t channel = 1; channel < MAX_CHANNELS; channel++)
+		current[ROOT_DOWNSTREAM_KEYER][channel] = obs_get_output_source(channel);
+	current[ROOT_PROGRAM][0] = obs_frontend_get_current_scene();
+	SetRoots(current);
+}
+
+void TallyEngine::Clear()
+{
+	obs_source_t *none[ROOT_COUNT][MAX_CHANNELS] = {};
+	SetRoots(none);
+	std::lock_guard<std::mutex> lock(dirtyMutex);
+	dirty.clear();
+	renamed.clear();
+}
+
+void TallyEngine::Renamed(obs_source_t *source)
+{
+	{
+		std::lock_guard<std::mutex> lock(dirtyMutex);
+		renamed.insert(source);
+	}
+	changed();
+}
+
+int TallyEngine::GetState(obs_source_t *source) const
+{
+	// Program wins over the downstream keyer, which wins over preview.
+	std::string privateKey;
+	for (int root = ROOT_COUNT - 1; root >= 0; root--) {
+		if (reach[root].count(source))
+			return root_states[root];
+		if (privateReach[root].empty())
+			continue;
+		if (privateKey.empty())
+			privateKey = PrivateKey(source);
+		if (privateReach[root].count(privateKey))
+			return root_states[root];
+	}
+	return ACTIVE_NONE;
+}
+
+void TallyEngine::Resolve(const std::vector<obs_source_t *> &sources, std::vector<int> &states) const
+{
+	int programState = ACTIVE_PROGRAM;
+	if (obs_frontend_streaming_active()) {
+		if (obs_frontend_recording_active() && !obs_frontend_recording_paused())
+			programState = ACTIVE_RECORDING_AND_STREAMING;
+		else
+			programState = ACTIVE_STREAMING;
+	} else if (obs_frontend_recording_active()) {
+		programState = obs_frontend_recording_paused() ? ACTIVE_RECORDING_PAUSED : ACTIVE_RECORDING;
+	}
+
+	states.resize(sources.size());
+	for (size_t i = 0; i < sources.size(); i++) {
+		int state = sources[i] ? GetState(sources[i]) : ACTIVE_NONE;
+		if (state == ACTIVE_PROGRAM)
+			state = programState;
+		states[i] = state;
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "obs.h"
+
+#define ACTIVE_NONE 0
+#define ACTIVE_PREVIEW 1
+#define ACTIVE_PROGRAM 2
+#define ACTIVE_DOWNSTREAM_KEYER 3
+#define ACTIVE_STREAMING 4
+#define ACTIVE_RECORDING 5
+#define ACTIVE_RECORDING_AND_STREAMING 6
+#define ACTIVE_RECORDING_PAUSED 7
+
+// Keeps a count of paths from the preview scene, the downstream keyer
+// channels and the program scene to every source they reach. Each reachable
+// scene caches its visible children and listens to its item signals, so a
+// changed scene only updates the counts below it and a scene switch only
+// enumerates scenes that were not reachable yet.
+//
+// Transitions, like the ones downstream keyer channels output, and other
+// sources that show sources have no signal for every change of what they
+// show. They cache the sources they show as well, but are checked again on
+// every update. Transitions also request an update when they start or stop.
+//
+// Sources are matched by identity. Private duplicates (studio mode with
+// duplicated scenes) have no link to their original, they are matched by
+// type and name. Their cached key is updated when they are renamed.
+class TallyEngine {
+	enum { ROOT_PREVIEW, ROOT_DOWNSTREAM_KEYER, ROOT_PROGRAM, ROOT_COUNT };
+
+	struct Reach {
+		int count = 0;
+		std::string privateKey;
+	};
+
+	struct Node {
+		int count = 0;
+		bool scene = false;
+		bool transition = false;
+		std::vector<obs_source_t *> children;
+	};
+
+	std::unordered_map<obs_source_t *, Reach> reach[ROOT_COUNT];
+	std::unordered_map<std::string, int> privateReach[ROOT_COUNT];
+	std::unordered_map<obs_source_t *, Node> nodes;
+	std::unordered_set<obs_source_t *> sourceNodes;
+	obs_source_t *roots[ROOT_COUNT][MAX_CHANNELS] = {};
+
+	std::mutex dirtyMutex;
+	std::unordered_set<obs_source_t *> dirty;
+	std::unordered_set<obs_source_t *> renamed;
+	void (*changed)();
+
+	static std::string PrivateKey(obs_source_t *source);
+	static std::vector<obs_source_t *> GetChildren(obs_source_t *source);
+	static void SceneChanged(void *data, calldata_t *call_data);
+	static void TransitionChanged(void *data, calldata_t *call_data);
+
+	void Connect(obs_source_t *source, const Node &node, bool connect);
+	void AddReach(int root, obs_source_t *source, int count);
+	void SetRoots(obs_source_t *sources[ROOT_COUNT][MAX_CHANNELS]);
+	void RefreshNode(obs_source_t *source);
+	void RefreshPrivateKey(obs_source_t *source);
+	int GetState(obs_source_t *source) const;
+
+public:
+	// changed is called from any thread when a tracked scene changes.
+	explicit TallyEngine(void (*changed)());
+
+	// Call from the UI thread. Update follows the current roots and applies
+	// the pending scene changes, Clear drops everything.
+	void Update();
+	void Clear();
+
+	// Call from any thread when a source is renamed, the next Update
+	// applies it.
+	void Renamed(obs_source_t *source);
+
+	// Fills states with one tally state per entry in sources, call after
+	// Update.
+	void Resolve(const std::vector<obs_source_t *> &sources, std::vector<int> &states) const;
+};
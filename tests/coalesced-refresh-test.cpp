@@ -0,0 +1,67 @@
+#include "test.hpp"
+#include "coalesced-refresh.hpp"
+
+#include <thread>
+#include <vector>
+
+// A burst of item signals from several threads, like a scene collection
+// load or a script adding items, before the UI thread gets to run.
+static void test_burst_queues_once()
+{
+	CoalescedRefresh refresh;
+	std::atomic<int> queued{0};
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.emplace_back([&]() {
+			for (int i = 0; i < 1000; i++) {
+				if (refresh.Signal())
+					queued++;
+			}
+		});
+	}
+	for (auto &thread : threads)
+		thread.join();
+	CHECK(queued == 1);
+
+	refresh.Begin();
+	uint64_t signals, refreshes;
+	refresh.TakeCounts(signals, refreshes);
+	CHECK(signals == 4000);
+	CHECK(refreshes == 1);
+
+	refresh.TakeCounts(signals, refreshes);
+	CHECK(signals == 0);
+	CHECK(refreshes == 0);
+}
+
+// Signals that arrive while the refresh runs queue the next one, the last
+// change is never lost.
+static void test_signal_during_refresh()
+{
+	CoalescedRefresh refresh;
+	int queued = 0;
+	for (int burst = 0; burst < 100; burst++) {
+		for (int i = 0; i < 10; i++) {
+			if (refresh.Signal())
+				queued++;
+		}
+		refresh.Begin();
+		if (refresh.Signal())
+			queued++;
+		refresh.Begin();
+	}
+	CHECK(queued == 200);
+	CHECK(refresh.Signal());
+
+	uint64_t signals, refreshes;
+	refresh.TakeCounts(signals, refreshes);
+	CHECK(signals == 1101);
+	CHECK(refreshes == 200);
+}
+
+int main()
+{
+	test_burst_queues_once();
+	test_signal_during_refresh();
+	return test_failures;
+}
@@ -0,0 +1,78 @@
+#include "test.hpp"
+#include "fader-law.hpp"
+
+#include <cmath>
+
+// The formulas the dock used before the fader law tables.
+#define LOG_OFFSET_DB 6.0f
+#define LOG_RANGE_DB 96.0f
+#define LOG_OFFSET_VAL -0.77815125038364363f
+#define LOG_RANGE_VAL -2.00860017176191756f
+
+static float old_def_to_db(float def)
+{
+	if (def >= 1.0f)
+		return 0.0f;
+	if (def <= 0.0f)
+		return -INFINITY;
+	return -(LOG_RANGE_DB + LOG_OFFSET_DB) * powf((LOG_RANGE_DB + LOG_OFFSET_DB) / LOG_OFFSET_DB, -def) + LOG_OFFSET_DB;
+}
+
+static float old_db_to_def(float db)
+{
+	if (db >= 0.0f)
+		return 1.0f;
+	if (db <= -96.0f)
+		return 0.0f;
+	return (-log10f(-db + LOG_OFFSET_DB) - LOG_RANGE_VAL) / (LOG_OFFSET_VAL - LOG_RANGE_VAL);
+}
+
+static void test_log_law_matches_old_formulas()
+{
+	// Every slider step, the slider range is 0 - 10000.
+	float maxDbError = 0.0f;
+	float maxDefError = 0.0f;
+	for (int step = 1; step < 10000; step++) {
+		const float def = (float)step / 10000.0f;
+		const float db = fader_def_to_db(FADER_LAW_LOG, def);
+		maxDbError = std::fmax(maxDbError, std::fabs(db - old_def_to_db(def)));
+		if (db > FADER_LAW_MINIMUM_DB)
+			maxDefError = std::fmax(maxDefError, std::fabs(fader_db_to_def(FADER_LAW_LOG, db) - old_db_to_def(db)));
+	}
+	printf("log law: max dB error %g, max def error %g\n", maxDbError, maxDefError);
+	CHECK(maxDbError < 0.001f);
+	CHECK(maxDefError < 0.00001f);
+	CHECK(fader_def_to_db(FADER_LAW_LOG, 1.0f) == 0.0f);
+	CHECK(std::isinf(fader_def_to_db(FADER_LAW_LOG, 0.0f)));
+	CHECK(fader_db_to_def(FADER_LAW_LOG, 0.0f) == 1.0f);
+	CHECK(fader_db_to_def(FADER_LAW_LOG, -200.0f) == 0.0f);
+}
+
+static void test_round_trip()
+{
+	for (int law = 0; law < FADER_LAW_COUNT; law++) {
+		float maxError = 0.0f;
+		float previousDb = -INFINITY;
+		bool increasing = true;
+		for (int step = 1; step < 10000; step++) {
+			const float def = (float)step / 10000.0f;
+			const float db = fader_def_to_db(law, def);
+			if (db < previousDb)
+				increasing = false;
+			previousDb = db;
+			if (!std::isfinite(db) || db <= FADER_LAW_MINIMUM_DB)
+				continue;
+			maxError = std::fmax(maxError, std::fabs(fader_db_to_def(law, db) - def));
+		}
+		printf("%s: max round trip error %g\n", fader_law_name(law), maxError);
+		CHECK(increasing);
+		CHECK(maxError < 0.0001f);
+	}
+}
+
+int main()
+{
+	test_log_law_matches_old_formulas();
+	test_round_trip();
+	return test_failures;
+}
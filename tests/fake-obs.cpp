@@ -0,0 +1,385 @@
+#include "fake-obs.hpp"
+
+#include <obs-frontend-api.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+
+struct signal_handler {
+	struct Slot {
+		std::string signal;
+		signal_callback_t callback;
+		void *data;
+	};
+	std::vector<Slot> slots;
+};
+
+struct obs_source {
+	std::string id;
+	std::string uuid;
+	std::string name;
+	enum obs_source_type type;
+	bool is_private;
+	bool group = false;
+	long refs = 1;
+	signal_handler signals;
+	obs_scene_t *scene = nullptr;
+	std::vector<obs_source_t *> active;
+};
+
+struct obs_scene {
+	obs_source_t *source;
+	std::vector<obs_sceneitem_t *> items;
+};
+
+struct obs_scene_item {
+	obs_scene_t *parent;
+	obs_source_t *source;
+	int64_t id;
+	bool visible;
+};
+
+struct fake_param {
+	const char *name;
+	void *ptr;
+};
+
+static std::vector<std::unique_ptr<obs_source>> sources;
+static std::vector<std::unique_ptr<obs_scene>> scenes;
+static std::vector<std::unique_ptr<obs_scene_item>> items;
+static obs_source_t *preview = nullptr;
+static obs_source_t *program = nullptr;
+static obs_source_t *outputs[MAX_CHANNELS] = {};
+static int64_t last_item_id = 0;
+static int scene_enumerations = 0;
+
+static void emit(obs_source_t *source, const char *signal, fake_param *params, size_t count)
+{
+	calldata_t data = {};
+	data.stack = reinterpret_cast<uint8_t *>(params);
+	data.size = count;
+	// Callbacks can connect or disconnect while the signal is emitted.
+	const std::vector<signal_handler::Slot> slots = source->signals.slots;
+	for (const auto &slot : slots) {
+		if (slot.signal == signal)
+			slot.callback(slot.data, &data);
+	}
+}
+
+static void emit_item(obs_sceneitem_t *item, const char *signal)
+{
+	fake_param params[] = {{"scene", item->parent}, {"item", item}};
+	emit(item->parent->source, signal, params, 2);
+}
+
+obs_source_t *fake_create_source(const char *name, enum obs_source_type type, bool is_private)
+{
+	auto source = std::make_unique<obs_source>();
+	source->id = type == OBS_SOURCE_TYPE_TRANSITION ? "fade_transition" : "color_source";
+	source->uuid = "00000000-0000-0000-0000-" + std::to_string(100000000000 + sources.size());
+	source->name = name;
+	source->type = type;
+	source->is_private = is_private;
+	sources.push_back(std::move(source));
+	return sources.back().get();
+}
+
+obs_source_t *fake_create_scene(const char *name, bool is_private)
+{
+	obs_source_t *source = fake_create_source(name, OBS_SOURCE_TYPE_SCENE, is_private);
+	source->id = "scene";
+	scenes.push_back(std::make_unique<obs_scene>());
+	source->scene = scenes.back().get();
+	source->scene->source = source;
+	return source;
+}
+
+obs_source_t *fake_create_group(const char *name)
+{
+	obs_source_t *source = fake_create_scene(name);
+	source->id = "group";
+	source->group = true;
+	return source;
+}
+
+obs_sceneitem_t *fake_add_item(obs_source_t *scene, obs_source_t *source, bool visible)
+{
+	items.push_back(std::make_unique<obs_scene_item>());
+	obs_sceneitem_t *item = items.back().get();
+	item->parent = scene->scene;
+	item->source = source;
+	item->id = ++last_item_id;
+	item->visible = visible;
+	scene->scene->items.push_back(item);
+	emit_item(item, "item_add");
+	return item;
+}
+
+void fake_remove_item(obs_sceneitem_t *item)
+{
+	auto &list = item->parent->items;
+	list.erase(std::find(list.begin(), list.end(), item));
+	emit_item(item, "item_remove");
+}
+
+void fake_set_visible(obs_sceneitem_t *item, bool visible)
+{
+	item->visible = visible;
+	emit_item(item, "item_visible");
+}
+
+void fake_set_active_sources(obs_source_t *transition, const std::vector<obs_source_t *> &active)
+{
+	transition->active = active;
+	fake_param params[] = {{"source", transition}};
+	emit(transition, "transition_start", params, 1);
+}
+
+void fake_rename(obs_source_t *source, const char *name)
+{
+	source->name = name;
+}
+
+static void set_root(obs_source_t *&root, obs_source_t *source)
+{
+	if (source)
+		source->refs++;
+	if (root)
+		root->refs--;
+	root = source;
+}
+
+void fake_set_preview(obs_source_t *source)
+{
+	set_root(preview, source);
+}
+
+void fake_set_program(obs_source_t *source)
+{
+	set_root(program, source);
+}
+
+void fake_set_output(uint32_t channel, obs_source_t *source)
+{
+	set_root(outputs[channel], source);
+}
+
+bool fake_reaches(obs_source_t *root, obs_source_t *target)
+{
+	if (!root)
+		return false;
+	if (root == target)
+		return true;
+	if (root->scene) {
+		for (auto item : root->scene->items) {
+			if (item->visible && fake_reaches(item->source, target))
+				return true;
+		}
+	}
+	for (auto source : root->active) {
+		if (fake_reaches(source, target))
+			return true;
+	}
+	return false;
+}
+
+long fake_refs(obs_source_t *source)
+{
+	return source->refs;
+}
+
+size_t fake_signal_connections()
+{
+	size_t count = 0;
+	for (const auto &source : sources)
+		count += source->signals.slots.size();
+	return count;
+}
+
+int fake_scene_enumerations()
+{
+	return scene_enumerations;
+}
+
+void fake_reset()
+{
+	preview = nullptr;
+	program = nullptr;
+	std::fill(std::begin(outputs), std::end(outputs), nullptr);
+	items.clear();
+	scenes.clear();
+	sources.clear();
+	scene_enumerations = 0;
+}
+
+void blog(int log_level, const char *format, ...)
+{
+	UNUSED_PARAMETER(log_level);
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fputc('\n', stderr);
+}
+
+bool calldata_get_data(const calldata_t *data, const char *name, void *out, size_t size)
+{
+	const auto params = reinterpret_cast<const fake_param *>(data->stack);
+	for (size_t i = 0; i < data->size; i++) {
+		if (strcmp(params[i].name, name) == 0) {
+			memcpy(out, &params[i].ptr, std::min(size, sizeof(void *)));
+			return true;
+		}
+	}
+	return false;
+}
+
+const char *obs_source_get_unversioned_id(const obs_source_t *source)
+{
+	return source->id.c_str();
+}
+
+const char *obs_source_get_uuid(const obs_source_t *source)
+{
+	return source->uuid.c_str();
+}
+
+const char *obs_source_get_name(const obs_source_t *source)
+{
+	return source->name.c_str();
+}
+
+enum obs_source_type obs_source_get_type(const obs_source_t *source)
+{
+	return source->type;
+}
+
+bool obs_source_configurable(const obs_source_t *source)
+{
+	return source->type != OBS_SOURCE_TYPE_SCENE;
+}
+
+bool obs_obj_is_private(void *obj)
+{
+	return static_cast<obs_source_t *>(obj)->is_private;
+}
+
+obs_source_t *obs_source_get_ref(obs_source_t *source)
+{
+	if (!source || source->refs <= 0)
+		return nullptr;
+	source->refs++;
+	return source;
+}
+
+void obs_source_release(obs_source_t *source)
+{
+	if (source)
+		source->refs--;
+}
+
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source)
+{
+	return const_cast<signal_handler_t *>(&source->signals);
+}
+
+void signal_handler_connect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	handler->slots.push_back({signal, callback, data});
+}
+
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	auto &slots = handler->slots;
+	for (auto it = slots.begin(); it != slots.end(); ++it) {
+		if (it->signal == signal && it->callback == callback && it->data == data) {
+			slots.erase(it);
+			return;
+		}
+	}
+}
+
+void obs_source_enum_active_sources(obs_source_t *source, obs_source_enum_proc_t enum_callback, void *param)
+{
+	for (auto child : source->active)
+		enum_callback(source, child, param);
+}
+
+obs_scene_t *obs_group_or_scene_from_source(const obs_source_t *source)
+{
+	return source ? source->scene : nullptr;
+}
+
+obs_source_t *obs_scene_get_source(const obs_scene_t *scene)
+{
+	return scene->source;
+}
+
+void obs_scene_enum_items(obs_scene_t *scene, bool (*callback)(obs_scene_t *, obs_sceneitem_t *, void *), void *param)
+{
+	scene_enumerations++;
+	for (auto item : scene->items) {
+		if (!callback(scene, item, param))
+			return;
+	}
+}
+
+void obs_sceneitem_group_enum_items(obs_sceneitem_t *group, bool (*callback)(obs_scene_t *, obs_sceneitem_t *, void *),
+				    void *param)
+{
+	obs_scene_enum_items(group->source->scene, callback, param);
+}
+
+bool obs_sceneitem_is_group(obs_sceneitem_t *item)
+{
+	return item->source->group;
+}
+
+bool obs_sceneitem_visible(const obs_sceneitem_t *item)
+{
+	return item->visible;
+}
+
+obs_source_t *obs_sceneitem_get_source(const obs_sceneitem_t *item)
+{
+	return item->source;
+}
+
+int64_t obs_sceneitem_get_id(const obs_sceneitem_t *item)
+{
+	return item->id;
+}
+
+obs_source_t *obs_get_output_source(uint32_t channel)
+{
+	return obs_source_get_ref(outputs[channel]);
+}
+
+obs_source_t *obs_frontend_get_current_scene(void)
+{
+	return obs_source_get_ref(program);
+}
+
+obs_source_t *obs_frontend_get_current_preview_scene(void)
+{
+	return obs_source_get_ref(preview);
+}
+
+bool obs_frontend_streaming_active(void)
+{
+	return false;
+}
+
+bool obs_frontend_recording_active(void)
+{
+	return false;
+}
+
+bool obs_frontend_recording_paused(void)
+{
+	return false;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+#include <obs.h>
+
+// A small stand in for the parts of libobs and the frontend api that the
+// tally engine calls. Sources, scenes and items live until fake_reset, the
+// tests check the reference counts the engine leaves behind.
+obs_source_t *fake_create_source(const char *name, enum obs_source_type type = OBS_SOURCE_TYPE_INPUT, bool is_private = false);
+obs_source_t *fake_create_scene(const char *name, bool is_private = false);
+obs_source_t *fake_create_group(const char *name);
+obs_sceneitem_t *fake_add_item(obs_source_t *scene, obs_source_t *source, bool visible = true);
+void fake_remove_item(obs_sceneitem_t *item);
+void fake_set_visible(obs_sceneitem_t *item, bool visible);
+void fake_set_active_sources(obs_source_t *transition, const std::vector<obs_source_t *> &sources);
+void fake_rename(obs_source_t *source, const char *name);
+
+void fake_set_preview(obs_source_t *source);
+void fake_set_program(obs_source_t *source);
+void fake_set_output(uint32_t channel, obs_source_t *source);
+
+// True when target is shown below root, following visible items and the
+// active sources of other sources.
+bool fake_reaches(obs_source_t *root, obs_source_t *target);
+
+long fake_refs(obs_source_t *source);
+size_t fake_signal_connections();
+int fake_scene_enumerations();
+void fake_reset();
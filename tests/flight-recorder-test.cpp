@@ -0,0 +1,170 @@
+#include "test.hpp"
+#include "flight-recorder-format.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#define FLIGHT_TEST_CAPACITY 16
+
+struct Ring {
+	std::vector<uint8_t> map = std::vector<uint8_t>((size_t)flight_recorder_size(FLIGHT_TEST_CAPACITY));
+
+	Ring() { flight_recorder_init(map.data(), FLIGHT_TEST_CAPACITY); }
+	FlightRecorderHeader *Header() { return reinterpret_cast<FlightRecorderHeader *>(map.data()); }
+	FlightRecord *Records() { return reinterpret_cast<FlightRecord *>(map.data() + sizeof(FlightRecorderHeader)); }
+	void Write(uint32_t type, const char *source, double value, uint64_t timestamp)
+	{
+		flight_recorder_write(Header(), Records(), FLIGHT_TEST_CAPACITY, type, source, value, timestamp);
+	}
+};
+
+static void test_wraps()
+{
+	Ring ring;
+	std::vector<FlightRecord> records;
+	CHECK(flight_recorder_read(ring.map.data(), ring.map.size(), records));
+	CHECK(records.empty());
+
+	for (int i = 1; i <= 40; i++)
+		ring.Write(FLIGHT_RECORD_VOLUME, "Mic/Aux", (double)i, 1000 + i);
+	CHECK(flight_recorder_read(ring.map.data(), ring.map.size(), records));
+	CHECK(records.size() == FLIGHT_TEST_CAPACITY);
+	for (size_t i = 0; i < records.size(); i++) {
+		CHECK(records[i].sequence == 25 + i);
+		CHECK(records[i].value == (double)(25 + i));
+		CHECK(records[i].timestamp == 1025 + i);
+		CHECK(strcmp(records[i].source, "Mic/Aux") == 0);
+	}
+
+	// Long names are cut, the record stays terminated.
+	ring.Write(FLIGHT_RECORD_TALLY, "A source name longer than thirty-one characters", 1.0, 0);
+	CHECK(flight_recorder_read(ring.map.data(), ring.map.size(), records));
+	CHECK(!records.empty() && strlen(records.back().source) == sizeof(records.back().source) - 1);
+}
+
+static void test_skips_torn_records()
+{
+	Ring ring;
+	for (int i = 1; i <= 20; i++)
+		ring.Write(FLIGHT_RECORD_LEVEL, "Camera", (double)i, 0);
+
+	// A writer died in the middle of a record, and a slot holds a sequence
+	// that does not belong to it.
+	FlightRecord *slots = ring.Records();
+	flight_recorder_atomic(slots[3].sequence).store(0);
+	flight_recorder_atomic(slots[7].sequence).store(7 + 1 + 1);
+
+	std::vector<FlightRecord> records;
+	CHECK(flight_recorder_read(ring.map.data(), ring.map.size(), records));
+	CHECK(records.size() == FLIGHT_TEST_CAPACITY - 2);
+	for (const auto &record : records) {
+		CHECK((record.sequence - 1) % FLIGHT_TEST_CAPACITY != 3);
+		CHECK((record.sequence - 1) % FLIGHT_TEST_CAPACITY != 7);
+		CHECK(record.value == (double)record.sequence);
+	}
+	for (size_t i = 1; i < records.size(); i++)
+		CHECK(records[i - 1].sequence < records[i].sequence);
+
+	// Anything else is not a ring.
+	CHECK(!flight_recorder_read(ring.map.data(), sizeof(FlightRecorderHeader) - 1, records));
+	CHECK(!flight_recorder_read(ring.map.data(), flight_recorder_size(FLIGHT_TEST_CAPACITY - 1), records));
+	ring.Header()->version++;
+	CHECK(!flight_recorder_read(ring.map.data(), ring.map.size(), records));
+}
+
+// Writers keep overwriting the ring while it is read, every record read must
+// be one that was written as a whole: its source names its value.
+static void test_live_ring()
+{
+	Ring ring;
+	std::atomic<bool> stop = false;
+	std::vector<std::thread> writers;
+	for (int w = 0; w < 4; w++) {
+		writers.emplace_back([&ring, &stop, w] {
+			for (int i = 0; !stop; i++) {
+				const int value = w * 1000000 + i % 1000000;
+				const std::string source = std::to_string(value);
+				ring.Write(FLIGHT_RECORD_LEVEL, source.c_str(), (double)value, (uint64_t)value);
+			}
+		});
+	}
+	int reads = 0;
+	int torn = 0;
+	std::vector<FlightRecord> records;
+	for (; reads < 2000; reads++) {
+		CHECK(flight_recorder_read(ring.map.data(), ring.map.size(), records));
+		for (const auto &record : records) {
+			if (std::to_string((int)record.value) != record.source || record.timestamp != (uint64_t)record.value)
+				torn++;
+		}
+	}
+	stop = true;
+	for (auto &writer : writers)
+		writer.join();
+	CHECK(torn == 0);
+}
+
+static std::vector<std::string> read_lines(const char *path)
+{
+	std::vector<std::string> lines;
+	std::ifstream file(path, std::ios::binary);
+	std::string line;
+	while (std::getline(file, line))
+		lines.push_back(line);
+	return lines;
+}
+
+static void test_dump(const char *tool)
+{
+	Ring ring;
+	for (int i = 1; i <= 20; i++)
+		ring.Write(FLIGHT_RECORD_MUTE, "Desktop \"Audio\"", (double)(i % 2), 5000 + i);
+	flight_recorder_atomic(ring.Records()[0].sequence).store(0);
+
+	const char *ringPath = "flight-recorder-test.bin";
+	const char *csvPath = "flight-recorder-test.csv";
+	{
+		std::ofstream file(ringPath, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char *>(ring.map.data()), (std::streamsize)ring.map.size());
+	}
+	remove(csvPath);
+	const std::string command = std::string("\"") + tool + "\" " + ringPath + " " + csvPath;
+	CHECK(std::system(command.c_str()) == 0);
+
+	const std::vector<std::string> lines = read_lines(csvPath);
+	CHECK(lines.size() == FLIGHT_TEST_CAPACITY);
+	CHECK(!lines.empty() && lines[0] == "sequence,timestamp_ns,type,source,value");
+	uint64_t sequence = 5;
+	for (size_t i = 1; i < lines.size(); i++, sequence++) {
+		if (sequence == FLIGHT_TEST_CAPACITY + 1)
+			sequence++;
+		std::ostringstream expected;
+		expected << sequence << "," << 5000 + sequence << ",mute,\"Desktop \"\"Audio\"\"\"," << sequence % 2;
+		CHECK(lines[i] == expected.str());
+	}
+
+	// The tool refuses files that are not a ring.
+	{
+		std::ofstream file(csvPath, std::ios::binary | std::ios::trunc);
+		file << "not a flight recorder\n";
+	}
+	const std::string bad = std::string("\"") + tool + "\" " + csvPath + " " + ringPath;
+	CHECK(std::system(bad.c_str()) != 0);
+
+	remove(ringPath);
+	remove(csvPath);
+}
+
+int main(int argc, char **argv)
+{
+	test_wraps();
+	test_skips_torn_records();
+	test_live_ring();
+	if (argc > 1)
+		test_dump(argv[1]);
+	return test_failures;
+}
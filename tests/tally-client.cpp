@@ -0,0 +1,32 @@
+#include "tally-client.hpp"
+#include "tally-server.hpp"
+
+#include <QCoreApplication>
+#include <QLocalSocket>
+#include <cstdio>
+
+// Reference client for the tally export, prints every change it receives
+// until OBS closes the socket.
+int main(int argc, char **argv)
+{
+	QCoreApplication app(argc, argv);
+	QLocalSocket socket;
+	socket.connectToServer(argc > 1 ? QString::fromLocal8Bit(argv[1]) : QStringLiteral(TALLY_SERVER_NAME));
+	if (!socket.waitForConnected(1000)) {
+		fprintf(stderr, "tally-client: %s\n", socket.errorString().toLocal8Bit().constData());
+		return 1;
+	}
+
+	TallyLineParser parser;
+	QObject::connect(&socket, &QLocalSocket::readyRead, [&]() {
+		const QByteArray data = socket.readAll();
+		std::vector<TallyEvent> events;
+		if (!parser.Feed(data.constData(), (size_t)data.size(), events))
+			fprintf(stderr, "tally-client: skipped a malformed line\n");
+		for (const auto &event : events)
+			printf("%s\t%s\n", event.state.c_str(), event.name.c_str());
+		fflush(stdout);
+	});
+	QObject::connect(&socket, &QLocalSocket::disconnected, &app, &QCoreApplication::quit);
+	return app.exec();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Reference parser for the tally export. The server pushes one line
+// "<state>\t<uuid>\t<name>\n" per change, the name is everything after the
+// second tab. Data can arrive in any chunks, a line is only parsed once its
+// newline arrived.
+struct TallyEvent {
+	std::string state;
+	std::string uuid;
+	std::string name;
+};
+
+static inline bool tally_state_known(const std::string &state)
+{
+	static const char *states[] = {"none",      "preview",   "program",             "dsk",
+				       "streaming", "recording", "streaming+recording", "recording-paused"};
+	for (const char *known : states) {
+		if (state == known)
+			return true;
+	}
+	return false;
+}
+
+class TallyLineParser {
+	std::string buffer;
+
+public:
+	// Appends data and adds an event for every complete line. Returns false
+	// when a line is malformed, that line is skipped.
+	bool Feed(const char *data, size_t size, std::vector<TallyEvent> &events)
+	{
+		buffer.append(data, size);
+		bool valid = true;
+		size_t start = 0;
+		for (size_t end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n', start)) {
+			const size_t stateEnd = buffer.find('\t', start);
+			const size_t uuidEnd = stateEnd < end ? buffer.find('\t', stateEnd + 1) : std::string::npos;
+			if (uuidEnd < end && tally_state_known(buffer.substr(start, stateEnd - start))) {
+				events.push_back({buffer.substr(start, stateEnd - start), buffer.substr(stateEnd + 1, uuidEnd - stateEnd - 1),
+						  buffer.substr(uuidEnd + 1, end - uuidEnd - 1)});
+			} else {
+				valid = false;
+			}
+			start = end + 1;
+		}
+		buffer.erase(0, start);
+		return valid;
+	}
+
+	// Bytes of a line whose newline has not arrived yet.
+	size_t Pending() const { return buffer.size(); }
+};
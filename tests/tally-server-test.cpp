@@ -0,0 +1,170 @@
+#include "test.hpp"
+#include "fake-obs.hpp"
+#include "tally-client.hpp"
+#include "tally-server.hpp"
+#include "tally.hpp"
+
+#include <QCoreApplication>
+#include <QDeadlineTimer>
+#include <QFile>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define TALLY_TEST_TIMEOUT_MS 2000
+
+static void test_parser_framing()
+{
+	const std::string stream = "program\tuuid-1\tCamera 1\n"
+				   "none\tuuid-2\tLower third: name\n"
+				   "streaming+recording\tuuid-3\t\n";
+
+	// Every split of the stream gives the same events.
+	for (size_t split = 0; split <= stream.size(); split++) {
+		TallyLineParser parser;
+		std::vector<TallyEvent> events;
+		CHECK(parser.Feed(stream.data(), split, events));
+		CHECK(parser.Feed(stream.data() + split, stream.size() - split, events));
+		CHECK(parser.Pending() == 0);
+		CHECK(events.size() == 3);
+		if (events.size() != 3)
+			continue;
+		CHECK(events[0].state == "program");
+		CHECK(events[0].uuid == "uuid-1");
+		CHECK(events[0].name == "Camera 1");
+		CHECK(events[1].name == "Lower third: name");
+		CHECK(events[2].state == "streaming+recording");
+		CHECK(events[2].name.empty());
+	}
+
+	// One byte at a time, nothing is parsed before the newline.
+	TallyLineParser parser;
+	std::vector<TallyEvent> events;
+	for (size_t i = 0; i + 1 < stream.size(); i++)
+		parser.Feed(stream.data() + i, 1, events);
+	CHECK(events.size() == 2);
+	CHECK(parser.Pending() == strlen("streaming+recording\tuuid-3\t"));
+
+	// Malformed lines are skipped, the lines around them still count.
+	const std::string bad = "program\tuuid-1\n"
+				"live\tuuid-2\tCamera\n"
+				"preview\tuuid-3\tSlides\n";
+	events.clear();
+	TallyLineParser badParser;
+	CHECK(!badParser.Feed(bad.data(), bad.size(), events));
+	CHECK(events.size() == 1);
+	CHECK(!events.empty() && events[0].name == "Slides");
+}
+
+// Reads from the socket until count events arrived, serving the server side
+// of the connection meanwhile.
+static std::vector<TallyEvent> read_events(QLocalSocket &socket, TallyLineParser &parser, size_t count)
+{
+	std::vector<TallyEvent> events;
+	QDeadlineTimer deadline(TALLY_TEST_TIMEOUT_MS);
+	while (events.size() < count && !deadline.hasExpired()) {
+		QCoreApplication::processEvents();
+		socket.waitForReadyRead(10);
+		const QByteArray data = socket.readAll();
+		CHECK(parser.Feed(data.constData(), (size_t)data.size(), events));
+	}
+	return events;
+}
+
+static void test_server_lines()
+{
+	obs_source_t *camera = fake_create_source("Camera\t1");
+	obs_source_t *slides = fake_create_source("Slides");
+
+	TallyServer server;
+	CHECK(server.Listen());
+	server.Publish({camera, slides}, {ACTIVE_PROGRAM, ACTIVE_NONE});
+
+	// A new client first gets the state of every source.
+	QLocalSocket socket;
+	socket.connectToServer(TALLY_SERVER_NAME);
+	CHECK(socket.waitForConnected(TALLY_TEST_TIMEOUT_MS));
+	TallyLineParser parser;
+	std::vector<TallyEvent> events = read_events(socket, parser, 2);
+	CHECK(events.size() == 2);
+	for (const auto &event : events) {
+		if (event.uuid == obs_source_get_uuid(camera)) {
+			CHECK(event.state == "program");
+			CHECK(event.name == "Camera 1");
+		} else {
+			CHECK(event.uuid == obs_source_get_uuid(slides));
+			CHECK(event.state == "none");
+		}
+	}
+
+	// Only changes are pushed, a source without a dock is sent as none once.
+	server.Publish({camera, slides}, {ACTIVE_PROGRAM, ACTIVE_PREVIEW});
+	events = read_events(socket, parser, 1);
+	CHECK(events.size() == 1);
+	CHECK(!events.empty() && events[0].state == "preview" && events[0].name == "Slides");
+	server.Publish({slides}, {ACTIVE_PREVIEW});
+	server.Publish({slides}, {ACTIVE_PREVIEW});
+	events = read_events(socket, parser, 1);
+	CHECK(events.size() == 1);
+	CHECK(!events.empty() && events[0].state == "none" && events[0].uuid == obs_source_get_uuid(camera));
+	QCoreApplication::processEvents();
+	CHECK(!socket.waitForReadyRead(50));
+	CHECK(parser.Pending() == 0);
+
+	fake_reset();
+}
+
+static void test_server_probe()
+{
+	{
+		TallyServer running;
+		CHECK(running.Listen());
+
+		// A second instance leaves the socket of a running one alone.
+		{
+			TallyServer second;
+			CHECK(!second.Listen());
+		}
+		QLocalSocket socket;
+		socket.connectToServer(TALLY_SERVER_NAME);
+		CHECK(socket.waitForConnected(TALLY_TEST_TIMEOUT_MS));
+		socket.abort();
+	}
+
+#ifndef _WIN32
+	// A crashed instance leaves its socket file behind, nothing accepts
+	// on it anymore.
+	QLocalServer local;
+	CHECK(local.listen(TALLY_SERVER_NAME));
+	const QString path = local.fullServerName();
+	local.close();
+	const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	strncpy(address.sun_path, path.toLocal8Bit().constData(), sizeof(address.sun_path) - 1);
+	CHECK(bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0);
+	close(fd);
+	CHECK(QFile::exists(path));
+
+	TallyServer restarted;
+	CHECK(restarted.Listen());
+	QLocalSocket socket;
+	socket.connectToServer(TALLY_SERVER_NAME);
+	CHECK(socket.waitForConnected(TALLY_TEST_TIMEOUT_MS));
+#endif
+}
+
+int main(int argc, char **argv)
+{
+	QCoreApplication app(argc, argv);
+	test_parser_framing();
+	test_server_lines();
+	test_server_probe();
+	return test_failures;
+}
@@ -0,0 +1,239 @@
+#include "test.hpp"
+#include "fake-obs.hpp"
+#include "tally.hpp"
+
+#include <chrono>
+
+static int changes = 0;
+
+static void changed()
+{
+	changes++;
+}
+
+static int get_state(TallyEngine &engine, obs_source_t *source)
+{
+	std::vector<int> states;
+	engine.Resolve({source}, states);
+	return states[0];
+}
+
+// Clear leaves every reference and signal the engine took behind.
+static void check_released(TallyEngine &engine, const std::vector<obs_source_t *> &sources)
+{
+	engine.Clear();
+	fake_set_program(nullptr);
+	fake_set_preview(nullptr);
+	for (auto source : sources)
+		CHECK(fake_refs(source) == 1);
+	CHECK(fake_signal_connections() == 0);
+}
+
+static void test_roots()
+{
+	TallyEngine engine(changed);
+	obs_source_t *program = fake_create_scene("Program");
+	obs_source_t *preview = fake_create_scene("Preview");
+	obs_source_t *camera = fake_create_source("Camera");
+	obs_source_t *slides = fake_create_source("Slides");
+	obs_source_t *logo = fake_create_source("Logo");
+	obs_source_t *group = fake_create_group("Group");
+	obs_source_t *keyer = fake_create_scene("Keyer");
+	obs_source_t *transition = fake_create_source("Fade", OBS_SOURCE_TYPE_TRANSITION);
+	obs_sceneitem_t *cameraItem = fake_add_item(program, camera);
+	fake_add_item(program, group);
+	obs_sceneitem_t *slidesItem = fake_add_item(group, slides, false);
+	fake_add_item(preview, camera);
+	fake_add_item(keyer, logo);
+	fake_set_program(program);
+	fake_set_preview(preview);
+	fake_set_output(1, transition);
+
+	engine.Update();
+	CHECK(get_state(engine, camera) == ACTIVE_PROGRAM);
+	CHECK(get_state(engine, slides) == ACTIVE_NONE);
+	CHECK(get_state(engine, logo) == ACTIVE_NONE);
+	CHECK(get_state(engine, preview) == ACTIVE_PREVIEW);
+
+	// Group members signal on the group.
+	changes = 0;
+	fake_set_visible(slidesItem, true);
+	CHECK(changes == 1);
+	engine.Update();
+	CHECK(get_state(engine, slides) == ACTIVE_PROGRAM);
+
+	fake_set_visible(cameraItem, false);
+	engine.Update();
+	CHECK(get_state(engine, camera) == ACTIVE_PREVIEW);
+
+	// The downstream keyer transition starts showing a scene.
+	changes = 0;
+	fake_set_active_sources(transition, {keyer});
+	CHECK(changes == 1);
+	engine.Update();
+	CHECK(get_state(engine, logo) == ACTIVE_DOWNSTREAM_KEYER);
+	fake_set_active_sources(transition, {});
+	engine.Update();
+	CHECK(get_state(engine, logo) == ACTIVE_NONE);
+
+	fake_set_output(1, nullptr);
+	check_released(engine, {program, preview, camera, slides, logo, group, keyer, transition});
+	fake_reset();
+}
+
+// Renames during a live tally, docks watch the original sources.
+static void test_rename()
+{
+	TallyEngine engine(changed);
+	obs_source_t *program = fake_create_scene("Program");
+	obs_source_t *camera = fake_create_source("Camera");
+	obs_source_t *other = fake_create_source("Other");
+	fake_add_item(program, camera);
+	fake_set_program(program);
+	engine.Update();
+	CHECK(get_state(engine, camera) == ACTIVE_PROGRAM);
+
+	// Identity survives a rename, and taking over the old name does not
+	// take over the tally.
+	changes = 0;
+	fake_rename(camera, "Camera 2");
+	engine.Renamed(camera);
+	fake_rename(other, "Camera");
+	engine.Renamed(other);
+	CHECK(changes == 2);
+	engine.Update();
+	CHECK(get_state(engine, camera) == ACTIVE_PROGRAM);
+	CHECK(get_state(engine, other) == ACTIVE_NONE);
+
+	// Studio mode shows private duplicates in the preview, they only
+	// match their original by type and name.
+	obs_source_t *title = fake_create_source("Title");
+	obs_source_t *duplicateScene = fake_create_scene("Program", true);
+	obs_source_t *duplicate = fake_create_source("Title", OBS_SOURCE_TYPE_INPUT, true);
+	obs_sceneitem_t *duplicateItem = fake_add_item(duplicateScene, duplicate);
+	fake_set_preview(duplicateScene);
+	engine.Update();
+	CHECK(get_state(engine, title) == ACTIVE_PREVIEW);
+
+	fake_rename(title, "Lower Third");
+	engine.Renamed(title);
+	engine.Update();
+	CHECK(get_state(engine, title) == ACTIVE_NONE);
+
+	// The duplicate follows within the same update as another change.
+	fake_rename(duplicate, "Lower Third");
+	engine.Renamed(duplicate);
+	fake_set_visible(duplicateItem, false);
+	fake_set_visible(duplicateItem, true);
+	engine.Update();
+	CHECK(get_state(engine, title) == ACTIVE_PREVIEW);
+	CHECK(get_state(engine, other) == ACTIVE_NONE);
+
+	// Hiding it removes the count under the new name.
+	fake_set_visible(duplicateItem, false);
+	engine.Update();
+	CHECK(get_state(engine, title) == ACTIVE_NONE);
+
+	check_released(engine, {program, camera, other, title, duplicateScene, duplicate});
+	fake_reset();
+}
+
+// 2000 nodes below the program scene: 20 scenes of 99 sources each, the
+// preview scene shares half of them.
+static void test_benchmark()
+{
+	const int sceneCount = 20;
+	const int sourcesPerScene = 99;
+	const size_t dockCount = 200;
+
+	TallyEngine engine(changed);
+	obs_source_t *program = fake_create_scene("Program");
+	obs_source_t *preview = fake_create_scene("Preview");
+	std::vector<obs_source_t *> all = {program, preview};
+	std::vector<obs_sceneitem_t *> items;
+	std::vector<obs_source_t *> scenes;
+	for (int s = 0; s < sceneCount; s++) {
+		obs_source_t *scene = fake_create_scene(("Scene " + std::to_string(s)).c_str());
+		scenes.push_back(scene);
+		all.push_back(scene);
+		fake_add_item(program, scene);
+		if (s % 2)
+			fake_add_item(preview, scene);
+		for (int i = 0; i < sourcesPerScene; i++) {
+			obs_source_t *source = fake_create_source(("Source " + std::to_string(s * sourcesPerScene + i)).c_str());
+			all.push_back(source);
+			items.push_back(fake_add_item(scene, source, i % 3 != 0));
+		}
+	}
+	std::vector<obs_source_t *> docks;
+	for (size_t i = 0; i < dockCount; i++)
+		docks.push_back(all[(i * 37) % all.size()]);
+	fake_set_program(program);
+	fake_set_preview(preview);
+
+	auto check_states = [&]() {
+		std::vector<int> states;
+		engine.Resolve(docks, states);
+		for (size_t i = 0; i < docks.size(); i++) {
+			int expected = ACTIVE_NONE;
+			if (fake_reaches(program, docks[i]))
+				expected = ACTIVE_PROGRAM;
+			else if (fake_reaches(preview, docks[i]))
+				expected = ACTIVE_PREVIEW;
+			CHECK(states[i] == expected);
+		}
+	};
+
+	using clock = std::chrono::steady_clock;
+	auto start = clock::now();
+	engine.Update();
+	const double buildUs = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+	CHECK(fake_scene_enumerations() == sceneCount + 2);
+	check_states();
+
+	// An item change only enumerates the scene it is in.
+	const int iterations = 1000;
+	std::vector<int> states;
+	start = clock::now();
+	for (int i = 0; i < iterations; i++) {
+		obs_sceneitem_t *item = items[(i * 7919) % items.size()];
+		const int enumerations = fake_scene_enumerations();
+		fake_set_visible(item, !obs_sceneitem_visible(item));
+		engine.Update();
+		engine.Resolve(docks, states);
+		CHECK(fake_scene_enumerations() == enumerations + 1);
+	}
+	const double changeUs = std::chrono::duration<double, std::micro>(clock::now() - start).count() / iterations;
+	check_states();
+
+	// Swapping preview and program only moves counts.
+	start = clock::now();
+	const int enumerations = fake_scene_enumerations();
+	fake_set_program(preview);
+	fake_set_preview(program);
+	engine.Update();
+	engine.Resolve(docks, states);
+	const double swapUs = std::chrono::duration<double, std::micro>(clock::now() - start).count();
+	CHECK(fake_scene_enumerations() == enumerations);
+	std::swap(program, preview);
+	check_states();
+
+	start = clock::now();
+	for (int i = 0; i < iterations; i++)
+		engine.Resolve(docks, states);
+	const double resolveUs = std::chrono::duration<double, std::micro>(clock::now() - start).count() / iterations;
+
+	printf("tally: %zu docks, %zu nodes: build %.0f us, item change %.1f us, swap %.0f us, resolve %.1f us\n", dockCount,
+	       all.size(), buildUs, changeUs, swapUs, resolveUs);
+
+	check_released(engine, all);
+	fake_reset();
+}
+
+int main()
+{
+	test_roots();
+	test_rename();
+	test_benchmark();
+	return test_failures;
+}
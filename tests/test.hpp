@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for the test executables, they return the failure count.
+static int test_failures = 0;
+
+#define CHECK(expr)                                                                        \
+	do {                                                                               \
+		if (!(expr)) {                                                             \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+			test_failures++;                                                   \
+		}                                                                          \
+	} while (0)
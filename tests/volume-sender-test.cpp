@@ -0,0 +1,221 @@
+#include "test.hpp"
+#include "volume-sender.hpp"
+
+#include <cmath>
+#include <vector>
+
+// The plumbing SourceDock keeps around VolumeSender: the tick timer, the
+// source volume and the volume signals it emits. Every decision is made by
+// VolumeSender, the same calls SourceDock makes.
+struct Dock {
+	VolumeSender sender;
+	bool ramp = false;
+	bool timerActive = false;
+	bool sliderDown = false;
+	float volume = 1.0f;
+	float shown = 1.0f;
+	std::vector<float> signals;
+	int setVolumeCalls = 0;
+	int shownUpdates = 0;
+	int ignoredUpdates = 0;
+
+	// obs_source_set_volume, from the dock or from anything else.
+	void SetVolume(float mul)
+	{
+		volume = mul;
+		signals.push_back(mul);
+	}
+
+	// SourceDock::SendVolume
+	void SendVolume()
+	{
+		float mul;
+		if (!sender.Tick(ramp, mul)) {
+			timerActive = false;
+			return;
+		}
+		setVolumeCalls++;
+		SetVolume(mul);
+	}
+
+	// SourceDock::SliderChanged
+	void SliderChanged(float mul)
+	{
+		shown = mul;
+		if (!sender.SliderChanged(mul))
+			return;
+		SendVolume();
+		if (sender.Ticking())
+			timerActive = true;
+	}
+
+	void Tick()
+	{
+		if (timerActive)
+			SendVolume();
+	}
+
+	// SourceDock::SetOutputVolume
+	void SetOutputVolume(float mul)
+	{
+		if (sender.Ignore(mul, sliderDown)) {
+			ignoredUpdates++;
+			return;
+		}
+		shown = mul;
+		shownUpdates++;
+	}
+
+	// The dock coalesces the signals, only the latest one is applied.
+	void DeliverLatest()
+	{
+		if (signals.empty())
+			return;
+		const float mul = signals.back();
+		signals.clear();
+		SetOutputVolume(mul);
+	}
+
+	// Delivers the signals in order, the newest keep of them stay queued.
+	void Deliver(size_t keep = 0)
+	{
+		while (signals.size() > keep) {
+			const float mul = signals.front();
+			signals.erase(signals.begin());
+			SetOutputVolume(mul);
+		}
+	}
+};
+
+// 1000 slider steps over one second with a tick every 10 ms, the echoes of
+// the sent changes arrive during the drag.
+static void test_drag_is_bounded()
+{
+	Dock dock;
+	dock.sliderDown = true;
+	int ticks = 0;
+	for (int step = 1; step <= 1000; step++) {
+		dock.SliderChanged((float)step / 1000.0f);
+		if (step % 10 == 0) {
+			dock.Tick();
+			ticks++;
+			if (ticks % 2)
+				dock.DeliverLatest();
+			else
+				dock.Deliver();
+		}
+	}
+	dock.sliderDown = false;
+	while (dock.timerActive) {
+		dock.Tick();
+		ticks++;
+	}
+	dock.Deliver();
+	CHECK(dock.setVolumeCalls <= ticks + 1);
+	CHECK(dock.setVolumeCalls <= 101);
+	CHECK(dock.volume == 1.0f);
+	// None of the echoes moved the slider.
+	CHECK(dock.shownUpdates == 0);
+	CHECK(dock.ignoredUpdates > 0);
+	CHECK(dock.shown == 1.0f);
+
+	// A script changing the volume afterwards is shown, also when it sets a
+	// value the drag sent before.
+	dock.SetVolume(0.5f);
+	dock.DeliverLatest();
+	CHECK(dock.shownUpdates == 1);
+	dock.SetVolume(1.0f);
+	dock.DeliverLatest();
+	CHECK(dock.shownUpdates == 2);
+	CHECK(dock.shown == 1.0f);
+}
+
+// Keyboard or wheel steps do not hold the slider down, and the echoes lag a
+// tick behind. The late ones arrive after the timer stopped.
+static void test_late_echoes()
+{
+	Dock dock;
+	for (int step = 1; step <= 1000; step++) {
+		dock.SliderChanged(1.0f - (float)step / 2000.0f);
+		if (step % 10 == 0) {
+			dock.Tick();
+			dock.Deliver(1);
+		}
+	}
+	while (dock.timerActive)
+		dock.Tick();
+	CHECK(!dock.signals.empty());
+	dock.Deliver();
+	CHECK(dock.setVolumeCalls <= 101);
+	CHECK(dock.shownUpdates == 0);
+	CHECK(dock.shown == 0.5f);
+}
+
+static void test_ramp_limits_steps()
+{
+	Dock dock;
+	dock.ramp = true;
+	dock.SliderChanged(1.0f);
+	dock.Tick();
+	dock.SliderChanged(std::pow(10.0f, -30.0f / 20.0f));
+	float previousDb = 20.0f * std::log10(dock.volume);
+	CHECK(std::fabs(previousDb + VOLUME_RAMP_DB_PER_TICK) < 0.001f);
+	while (dock.timerActive) {
+		dock.Tick();
+		const float db = 20.0f * std::log10(dock.volume);
+		CHECK(std::fabs(db - previousDb) <= VOLUME_RAMP_DB_PER_TICK + 0.001f);
+		previousDb = db;
+	}
+	CHECK(std::fabs(previousDb + 30.0f) < 0.001f);
+	CHECK(dock.setVolumeCalls == 11);
+	dock.Deliver();
+	CHECK(dock.shownUpdates == 0);
+}
+
+static void test_script_during_drag()
+{
+	// A script sets a value between two sent changes, the slider ends up
+	// showing what the source has.
+	Dock dock;
+	dock.SliderChanged(0.5f);
+	dock.SetVolume(0.3f);
+	dock.SliderChanged(0.6f);
+	dock.Tick();
+	while (dock.timerActive)
+		dock.Tick();
+	CHECK(dock.setVolumeCalls == 2);
+	dock.Deliver();
+	CHECK(dock.shown == dock.volume);
+
+	// The script value arrives coalesced with our echo, and the script sets
+	// our value again later.
+	dock.SliderChanged(0.25f);
+	dock.Tick();
+	dock.SetVolume(0.75f);
+	dock.DeliverLatest();
+	CHECK(dock.shown == 0.75f);
+	const int shownUpdates = dock.shownUpdates;
+	dock.SetVolume(0.25f);
+	dock.DeliverLatest();
+	CHECK(dock.shownUpdates == shownUpdates + 1);
+	CHECK(dock.shown == 0.25f);
+}
+
+static void test_reset()
+{
+	Dock dock;
+	dock.sender.Sent(0.1f);
+	dock.sender.Reset();
+	dock.SetOutputVolume(0.1f);
+	CHECK(dock.shownUpdates == 1);
+}
+
+int main()
+{
+	test_drag_is_bounded();
+	test_late_echoes();
+	test_ramp_limits_steps();
+	test_script_during_drag();
+	test_reset();
+	return test_failures;
+}
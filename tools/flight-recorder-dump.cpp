@@ -0,0 +1,104 @@
+#include "flight-recorder-format.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Dumps a flight recorder ring as CSV, oldest record first. It maps the file
+// like the plugin does, so it also works while OBS is still writing to it
+// or after OBS crashed.
+//
+// usage: flight-recorder-dump <flight-recorder.bin> [<output.csv>]
+
+struct MappedFile {
+	const uint8_t *data = nullptr;
+	uint64_t size = 0;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#endif
+
+	bool Open(const char *path)
+	{
+#ifdef _WIN32
+		// OBS keeps the file open for writing.
+		file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+				   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+			return false;
+		size = (uint64_t)fileSize.QuadPart;
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping)
+			return false;
+		data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		return data != nullptr;
+#else
+		const int fd = open(path, O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+			close(fd);
+			return false;
+		}
+		size = (uint64_t)st.st_size;
+		void *map = mmap(nullptr, (size_t)size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (map == MAP_FAILED)
+			return false;
+		data = static_cast<const uint8_t *>(map);
+		return true;
+#endif
+	}
+
+	~MappedFile()
+	{
+#ifdef _WIN32
+		if (data)
+			UnmapViewOfFile(data);
+		if (mapping)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+#else
+		if (data)
+			munmap(const_cast<uint8_t *>(data), (size_t)size);
+#endif
+	}
+};
+
+int main(int argc, char **argv)
+{
+	if (argc < 2 || argc > 3) {
+		fprintf(stderr, "usage: %s <flight-recorder.bin> [<output.csv>]\n", argv[0]);
+		return 2;
+	}
+	MappedFile ring;
+	if (!ring.Open(argv[1])) {
+		fprintf(stderr, "flight-recorder-dump: cannot map '%s'\n", argv[1]);
+		return 1;
+	}
+	std::vector<FlightRecord> records;
+	if (!flight_recorder_read(ring.data, ring.size, records)) {
+		fprintf(stderr, "flight-recorder-dump: '%s' is not a flight recorder file\n", argv[1]);
+		return 1;
+	}
+
+	FILE *out = argc > 2 ? fopen(argv[2], "wb") : stdout;
+	if (!out) {
+		fprintf(stderr, "flight-recorder-dump: cannot write '%s'\n", argv[2]);
+		return 1;
+	}
+	bool written = flight_recorder_write_csv(out, records);
+	if (out != stdout)
+		written = fclose(out) == 0 && written;
+	return written ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include "track-meter.hpp"
+#include "volume-meter.hpp"
+
+#include <obs-module.h>
+#include <QCursor>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMenu>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+
+#include <util/sse-intrin.h>
+
+#ifndef QT_UTF8
+#define QT_UTF8(str) QString::fromUtf8(str)
+#endif
+
+TrackTap *TrackTap::taps[MAX_AUDIO_MIXES] = {};
+
+TrackTap::TrackTap(size_t mix_) : mix(mix_) {}
+
+void TrackTap::AddMeter(size_t mix, VolumeMeter *meter)
+{
+	if (mix >= MAX_AUDIO_MIXES)
+		return;
+	TrackTap *tap = taps[mix];
+	if (!tap) {
+		tap = new TrackTap(mix);
+		taps[mix] = tap;
+		audio_output_connect(obs_get_audio(), mix, nullptr, OBSAudio, tap);
+	}
+	std::lock_guard<std::mutex> lock(tap->metersMutex);
+	tap->meters.push_back(meter);
+}
+
+void TrackTap::RemoveMeter(size_t mix, VolumeMeter *meter)
+{
+	if (mix >= MAX_AUDIO_MIXES || !taps[mix])
+		return;
+	TrackTap *tap = taps[mix];
+	{
+		std::lock_guard<std::mutex> lock(tap->metersMutex);
+		tap->meters.erase(std::remove(tap->meters.begin(), tap->meters.end(), meter), tap->meters.end());
+		if (!tap->meters.empty())
+			return;
+	}
+	audio_output_disconnect(obs_get_audio(), mix, OBSAudio, tap);
+	taps[mix] = nullptr;
+	delete tap;
+}
+
+// Peak of the absolute values and sum of squares, four samples per step.
+static void peak_and_square_sum(const float *samples, uint32_t frames, float &peak, float &sum)
+{
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 peakv = _mm_setzero_ps();
+	__m128 sumv = _mm_setzero_ps();
+	uint32_t i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const __m128 v = _mm_loadu_ps(samples + i);
+		peakv = _mm_max_ps(peakv, _mm_and_ps(v, absMask));
+		sumv = _mm_add_ps(sumv, _mm_mul_ps(v, v));
+	}
+
+	float peaks[4];
+	float sums[4];
+	_mm_storeu_ps(peaks, peakv);
+	_mm_storeu_ps(sums, sumv);
+	peak = std::max(std::max(peaks[0], peaks[1]), std::max(peaks[2], peaks[3]));
+	sum = sums[0] + sums[1] + sums[2] + sums[3];
+
+	for (; i < frames; i++) {
+		peak = std::max(peak, fabsf(samples[i]));
+		sum += samples[i] * samples[i];
+	}
+}
+
+void TrackTap::OBSAudio(void *param, size_t mix_idx, struct audio_data *data)
+{
+	UNUSED_PARAMETER(mix_idx);
+	auto tap = static_cast<TrackTap *>(param);
+	const size_t channels = audio_output_get_channels(obs_get_audio());
+
+	float magnitude[MAX_AUDIO_CHANNELS];
+	float peak[MAX_AUDIO_CHANNELS];
+	for (size_t channelNr = 0; channelNr < MAX_AUDIO_CHANNELS; channelNr++) {
+		if (channelNr >= channels || !data->data[channelNr] || !data->frames) {
+			magnitude[channelNr] = -INFINITY;
+			peak[channelNr] = -INFINITY;
+			continue;
+		}
+		float channelPeak;
+		float sum;
+		peak_and_square_sum((const float *)data->data[channelNr], data->frames, channelPeak, sum);
+		peak[channelNr] = obs_mul_to_db(channelPeak);
+		magnitude[channelNr] = obs_mul_to_db(sqrtf(sum / float(data->frames)));
+	}
+
+	std::lock_guard<std::mutex> lock(tap->metersMutex);
+	for (auto meter : tap->meters)
+		meter->setLevels(magnitude, peak, peak);
+}
+
+TrackMeters::TrackMeters(QWidget *parent) : QWidget(parent)
+{
+	auto layout = new QVBoxLayout;
+	layout->setContentsMargins(0, 0, 0, 0);
+	layout->setSpacing(2);
+	for (int i = 0; i < MAX_AUDIO_MIXES; i++) {
+		auto row = new QWidget;
+		auto rowLayout = new QHBoxLayout;
+		rowLayout->setContentsMargins(0, 0, 0, 0);
+		rowLayout->addWidget(new QLabel(QString::number(i + 1)));
+		row->setLayout(rowLayout);
+		row->setVisible(false);
+		layout->addWidget(row);
+		rows[i] = row;
+	}
+	setLayout(layout);
+	setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
+	setContextMenuPolicy(Qt::CustomContextMenu);
+	connect(this, &QWidget::customContextMenuRequested, this, &TrackMeters::ContextMenuRequested);
+}
+
+TrackMeters::~TrackMeters()
+{
+	SetTracks(0);
+}
+
+void TrackMeters::SetTracks(uint32_t tracks_)
+{
+	tracks = tracks_;
+	for (int i = 0; i < MAX_AUDIO_MIXES; i++) {
+		const bool show = (tracks & (1 << i)) != 0;
+		if (show && !meters[i]) {
+			meters[i] = new VolumeMeter(nullptr, nullptr);
+			meters[i]->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
+			rows[i]->layout()->addWidget(meters[i]);
+			TrackTap::AddMeter(i, meters[i]);
+		} else if (!show && meters[i]) {
+			TrackTap::RemoveMeter(i, meters[i]);
+			rows[i]->layout()->removeWidget(meters[i]);
+			meters[i]->deleteLater();
+			meters[i] = nullptr;
+		}
+		rows[i]->setVisible(show);
+	}
+}
+
+void TrackMeters::ContextMenuRequested()
+{
+	QMenu menu;
+	for (int i = 0; i < MAX_AUDIO_MIXES; i++) {
+		auto a = menu.addAction(QString::fromUtf8(obs_module_text("TrackNr")).arg(i + 1),
+					[this, i]() { SetTracks(tracks ^ (1 << i)); });
+		a->setCheckable(true);
+		a->setChecked((tracks & (1 << i)) != 0);
+	}
+	menu.exec(QCursor::pos());
+}
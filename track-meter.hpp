@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QWidget>
+#include <mutex>
+#include <vector>
+
+#include "obs.h"
+
+class VolumeMeter;
+
+// One audio_output_connect tap per output track, shared by every meter that
+// shows the track. The tap computes peak and RMS once per audio tick and
+// hands them to all meters.
+class TrackTap {
+	size_t mix;
+	std::mutex metersMutex;
+	std::vector<VolumeMeter *> meters;
+
+	static TrackTap *taps[MAX_AUDIO_MIXES];
+
+	static void OBSAudio(void *param, size_t mix_idx, struct audio_data *data);
+
+	explicit TrackTap(size_t mix);
+
+public:
+	static void AddMeter(size_t mix, VolumeMeter *meter);
+	static void RemoveMeter(size_t mix, VolumeMeter *meter);
+};
+
+class TrackMeters : public QWidget {
+	Q_OBJECT
+
+private:
+	uint32_t tracks = 0;
+	VolumeMeter *meters[MAX_AUDIO_MIXES] = {};
+	QWidget *rows[MAX_AUDIO_MIXES] = {};
+
+private slots:
+	void ContextMenuRequested();
+
+public:
+	explicit TrackMeters(QWidget *parent = nullptr);
+	~TrackMeters();
+
+	uint32_t GetTracks() const { return tracks; }
+	void SetTracks(uint32_t tracks);
+};
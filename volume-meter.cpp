@@ -278,17 +278,22 @@ VolumeMeter::VolumeMeter(QWidget *parent, obs_volmeter_t *obs_volmeter, bool ver
 	channels = (int)audio_output_get_channels(obs_get_audio());
 	doLayout();
 	handleChannelCofigurationChange();
-	updateTimerRef = updateTimer.toStrongRef();
-	if (!updateTimerRef) {
-		updateTimerRef = QSharedPointer<VolumeMeterTimer>::create();
-		updateTimerRef->setTimerType(Qt::PreciseTimer);
-		updateTimerRef->start(16);
-		updateTimer = updateTimerRef;
-	}
-
+	updateTimerRef = GetUpdateTimer();
 	updateTimerRef->AddVolControl(this);
 }
 
+QSharedPointer<VolumeMeterTimer> VolumeMeter::GetUpdateTimer()
+{
+	QSharedPointer<VolumeMeterTimer> timer = updateTimer.toStrongRef();
+	if (!timer) {
+		timer = QSharedPointer<VolumeMeterTimer>::create();
+		timer->setTimerType(Qt::PreciseTimer);
+		timer->start(16);
+		updateTimer = timer;
+	}
+	return timer;
+}
+
 VolumeMeter::~VolumeMeter()
 {
 	updateTimerRef->RemoveVolControl(this);
@@ -751,7 +756,8 @@ inline void VolumeMeter::doLayout()
 
 bool VolumeMeter::needLayoutChange()
 {
-	int currentNrAudioChannels = obs_volmeter_get_nr_channels(obs_volmeter);
+	int currentNrAudioChannels = obs_volmeter ? obs_volmeter_get_nr_channels(obs_volmeter)
+						  : (int)audio_output_get_channels(obs_get_audio());
 
 	if (!currentNrAudioChannels) {
 		struct obs_audio_info oai;
@@ -767,18 +773,18 @@ bool VolumeMeter::needLayoutChange()
 	return false;
 }
 
-void VolumeMeterTimer::AddVolControl(VolumeMeter *meter)
+void VolumeMeterTimer::AddVolControl(QWidget *meter)
 {
 	volumeMeters.push_back(meter);
 }
 
-void VolumeMeterTimer::RemoveVolControl(VolumeMeter *meter)
+void VolumeMeterTimer::RemoveVolControl(QWidget *meter)
 {
 	volumeMeters.removeOne(meter);
 }
 
 void VolumeMeterTimer::timerEvent(QTimerEvent *)
 {
-	for (VolumeMeter *meter : volumeMeters)
+	for (QWidget *meter : volumeMeters)
 		meter->update();
 }
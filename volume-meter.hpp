@@ -159,6 +159,8 @@ public:
 	virtual void wheelEvent(QWheelEvent *event) override;
 	void ShowOutputMeter(bool output);
 
+	static QSharedPointer<VolumeMeterTimer> GetUpdateTimer();
+
 protected:
 	void paintEvent(QPaintEvent *event) override;
 };
@@ -169,10 +171,10 @@ class VolumeMeterTimer : public QTimer {
 public:
 	inline VolumeMeterTimer() : QTimer() {}
 
-	void AddVolControl(VolumeMeter *meter);
-	void RemoveVolControl(VolumeMeter *meter);
+	void AddVolControl(QWidget *meter);
+	void RemoveVolControl(QWidget *meter);
 
 protected:
 	void timerEvent(QTimerEvent *event) override;
-	QList<VolumeMeter *> volumeMeters;
+	QList<QWidget *> volumeMeters;
 };
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#define VOLUME_RAMP_DB_PER_TICK 3.0f
+#define VOLUME_MINIMUM_DB -96.0f
+#define VOLUME_MAXIMUM_ECHOES 64
+
+// Decides what a dock sends to its source while the slider moves, and which
+// volume signals it shows. The dock only runs the tick timer and calls
+// obs_source_set_volume, so the tests drive the same code.
+//
+// Slider changes only set the target. The first change of a drag is sent
+// right away and starts the tick, after that Tick sends the latest target
+// once per audio tick until it is reached, so a drag sends at most one change
+// per tick however many steps the slider makes.
+//
+// Every change sent comes back as a volume signal, in order, but the dock
+// coalesces signals so older ones can be skipped. Sent values are kept until
+// their signal or a later one arrives, then forgotten, so the same value set
+// later by a script is still shown.
+class VolumeSender {
+	float target = 0.0f;
+	float sent = -1.0f;
+	bool ticking = false;
+	std::vector<float> echoes;
+
+	// Same as obs_mul_to_db and obs_db_to_mul, this header does not depend
+	// on libobs so it can be tested on its own.
+	static float MulToDb(float mul) { return mul == 0.0f ? -INFINITY : 20.0f * std::log10(mul); }
+	static float DbToMul(float db) { return std::isfinite(db) ? std::pow(10.0f, db / 20.0f) : 0.0f; }
+
+public:
+	// Returns true when the caller has to call Tick right away and start
+	// the tick timer.
+	bool SliderChanged(float mul)
+	{
+		target = mul;
+		if (ticking)
+			return false;
+		ticking = true;
+		return true;
+	}
+
+	// Returns false once the target has been sent, the caller stops the
+	// tick timer then. With ramp set each step is limited to
+	// VOLUME_RAMP_DB_PER_TICK to avoid zipper noise.
+	bool Tick(bool ramp, float &mul)
+	{
+		if (sent == target) {
+			ticking = false;
+			return false;
+		}
+		mul = target;
+		if (ramp && sent >= 0.0f) {
+			const float sentDb = std::fmax(MulToDb(sent), VOLUME_MINIMUM_DB);
+			const float targetDb = std::fmax(MulToDb(target), VOLUME_MINIMUM_DB);
+			if (std::fabs(targetDb - sentDb) > VOLUME_RAMP_DB_PER_TICK) {
+				const float db = sentDb + (targetDb > sentDb ? VOLUME_RAMP_DB_PER_TICK : -VOLUME_RAMP_DB_PER_TICK);
+				mul = db <= VOLUME_MINIMUM_DB ? 0.0f : DbToMul(db);
+			}
+		}
+		Sent(mul);
+		return true;
+	}
+
+	bool Ticking() const { return ticking; }
+
+	// For changes set on the source without Tick, like fader group members.
+	void Sent(float mul)
+	{
+		sent = mul;
+		if (echoes.size() >= VOLUME_MAXIMUM_ECHOES)
+			echoes.erase(echoes.begin());
+		echoes.push_back(mul);
+	}
+
+	// Returns true when a volume signal should not be shown: it is the echo
+	// of a sent change, or the slider is still moving.
+	bool Ignore(float mul, bool sliderDown)
+	{
+		bool echo = false;
+		for (size_t i = echoes.size(); i > 0; i--) {
+			if (echoes[i - 1] == mul) {
+				// Older sends came back before this one.
+				echoes.erase(echoes.begin(), echoes.begin() + i);
+				echo = true;
+				break;
+			}
+		}
+		// Anything else was set by someone else, show what follows it.
+		if (!echo)
+			echoes.clear();
+		return echo || ticking || sliderDown;
+	}
+
+	void Reset()
+	{
+		sent = -1.0f;
+		ticking = false;
+		echoes.clear();
+	}
+};